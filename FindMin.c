@@ -0,0 +1,1790 @@
+//===- FindMin.c --------------------------------------------------------------------------------------------------===//
+//
+// Parallel minimum search over arrays of any arithmetic type - see FindMin.h.
+//
+//===--------------------------------------------------------------------------------------------------------------===//
+// The kernels and searches are generated per element type by `FIND_MIN_DEFINE`. `int32_t` additionally has SIMD
+// kernels, chosen at load time according to what the CPU supports; the other types rely on the compiler vectorizing the
+// portable kernels.
+//===--------------------------------------------------------------------------------------------------------------===//
+
+#include "FindMin.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+// Compiles a function for AVX2 as well as the baseline instruction set, to be picked from by the CPU at load time
+#if defined(HAVE_X86_KERNELS) && defined(__linux__)
+#define FIND_MIN_TARGET_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define FIND_MIN_TARGET_CLONES
+#endif
+
+// Number of elements the portable kernels scan between checks against the sentinel
+#define FIND_MIN_BLOCK_SIZE 64
+// Number of elements `findSmallest<Type>()` checks for a candidate, and `findFirstBelow<Type>()` for a match, at a time
+#define FIND_MIN_SELECT_BLOCK_SIZE 256
+// Number of elements `findMinReduce<Type>()` runs each statistic over at a time (8 KiB of `int32_t`, to stay in L1)
+#define FIND_MIN_REDUCE_BLOCK_SIZE 2048
+// Number of copies of its histogram each thread of `findMinReduce<Type>()` counts into (unrolled by hand)
+#define FIND_MIN_HISTOGRAM_COPIES 4
+// The statistics of `findMinReduce<Type>()` other than the histogram, which its block functions compute
+#define FIND_MIN_REDUCE_SCALARS (FIND_MIN_MINIMUM | FIND_MIN_MAXIMUM | FIND_MIN_SUM | FIND_MIN_COUNT_BELOW)
+// Whether `type` is an integer type, as a constant expression
+#define FIND_MIN_IS_INTEGER(type) ((type) 0.5 == 0)
+// Number of range queries each thread of `findMinRanges<Type>()` must have to answer, at least
+#define FIND_MIN_RANGE_QUERY_CHUNK_SIZE 1024
+
+// The name of the `int32_t` kernel chosen by `selectKernels()`
+static char const * kernelName = "scalar";
+
+/**
+ * Returns the number of threads a search of `size` elements should use: as many as `options` asks for, but no more than
+ * there are chunks to search.
+ */
+static size_t resolveThreadCount(FindMinOptions const * options, size_t size, size_t chunkSize)
+{
+  size_t threadCount = options ? options->threadCount : 0;
+  if (threadCount == 0)
+  {
+    long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    threadCount = cpuCount > 0 ? (size_t) cpuCount : 1;
+  }
+  size_t chunkCount = size / chunkSize + (size % chunkSize != 0);
+  if (threadCount > chunkCount) threadCount = chunkCount;
+  return threadCount > 0 ? threadCount : 1;
+}
+
+/**
+ * Returns the base 2 logarithm of `x` (which must not be 0), rounded down.
+ */
+static size_t floorLog2(size_t x)
+{
+  size_t log = 0;
+  while (x >>= 1)
+  {
+    ++log;
+  }
+  return log;
+}
+
+/**
+ * Returns `offset * binCount / range`, rounded down, for an `offset` less than `range` and a `binCount` less than 2^32,
+ * computed exactly even when the product does not fit in 64 bits.
+ */
+static uint32_t exactBin(uint64_t offset, uint64_t binCount, uint64_t range)
+{
+  if (offset <= UINT64_MAX / binCount) return (uint32_t) (offset * binCount / range);
+  // Long multiplication by one bit of `binCount` at a time, keeping the quotient and the remainder by `range`
+  uint64_t quotient = 0;
+  uint64_t remainder = 0;
+  int bit;
+  for (bit = 31; bit >= 0; --bit)
+  {
+    quotient <<= 1;
+    if (remainder >= range - remainder)
+    {
+      remainder -= range - remainder;
+      ++quotient;
+    }
+    else
+    {
+      remainder <<= 1;
+    }
+    if ((binCount >> bit) & 1)
+    {
+      if (offset >= range - remainder)
+      {
+        remainder = offset - (range - remainder);
+        ++quotient;
+      }
+      else
+      {
+        remainder += offset;
+      }
+    }
+  }
+  return (uint32_t) quotient;
+}
+
+/**
+ * Runs `f` on each of the `count` slices of `sliceSize` bytes at `slices`, each on a thread of its own but the first,
+ * which runs on the calling thread, and returns once they are all done. Slices a thread cannot be created for are run
+ * on the calling thread too.
+ */
+static void runSlices(void * slices, size_t sliceSize, size_t count, void * (* f)(void *))
+{
+  pthread_t * threads = count > 1 ? (pthread_t *) malloc((count - 1) * sizeof(pthread_t)) : NULL;
+  char * threaded = count > 1 ? (char *) calloc(count - 1, 1) : NULL;
+  size_t i;
+  for (i = 1; i < count && threads && threaded; ++i)
+  {
+    threaded[i - 1] = pthread_create(&threads[i - 1], NULL, f, (char *) slices + i * sliceSize) == 0;
+  }
+  for (i = 0; i < count; ++i)
+  {
+    if (i == 0 || !threads || !threaded || !threaded[i - 1])
+    {
+      f((char *) slices + i * sliceSize);
+    }
+  }
+  for (i = 1; i < count && threads && threaded; ++i)
+  {
+    if (threaded[i - 1])
+    {
+      pthread_join(threads[i - 1], NULL);
+    }
+  }
+  free(threads);
+  free(threaded);
+}
+
+/**
+ * Defines a portable kernel named `name`, which returns the minimum of the `size` elements at `data`, or `highest` if
+ * `size` is 0. The inner loop has no early exit so the compiler is free to vectorize it. If `stopOnSentinel` is
+ * non-zero, the kernel returns as soon as its running minimum is no greater than `sentinel`, checking once per
+ * `FIND_MIN_BLOCK_SIZE` elements; otherwise `sentinel` is ignored and the check compiled out.
+ */
+#define FIND_MIN_DEFINE_KERNEL(name, type, highest, stopOnSentinel)                                                    \
+  static type name(type const * data, size_t size, type sentinel)                                                      \
+  {                                                                                                                    \
+    type min = highest;                                                                                                \
+    size_t i = 0;                                                                                                      \
+    (void) sentinel;                                                                                                   \
+    while (i < size)                                                                                                   \
+    {                                                                                                                  \
+      size_t blockEnd = size - i < FIND_MIN_BLOCK_SIZE ? size : i + FIND_MIN_BLOCK_SIZE;                               \
+      for (; i < blockEnd; ++i)                                                                                        \
+      {                                                                                                                \
+        min = data[i] < min ? data[i] : min;                                                                           \
+      }                                                                                                                \
+      if ((stopOnSentinel) && min <= sentinel) return min;                                                             \
+    }                                                                                                                  \
+    return min;                                                                                                        \
+  }
+
+/**
+ * Defines everything `FIND_MIN_DECLARE` declares for one element type, along with:
+ * `kernel<Type>` and `kernelUntil<Type>`, the kernels used for each policy - the portable ones, unless
+ * `selectKernels()` replaces them. Both take a sentinel, which `kernel<Type>` is always passed `lowest`.
+ * `FindMinSlice<Type>`, the part of a parallel search done by one thread. `stop` is shared by all the slices of a
+ * search and accessed only through the `__atomic` builtins; `threaded` tells whether the slice is searched by a thread
+ * of its own that has to be joined.
+ * `searchSlice<Type>()`, which searches a slice a chunk at a time, and `search<Type>()`, which splits a search into
+ * slices and searches them in parallel.
+ */
+#define FIND_MIN_DEFINE(suffix, type, lowest, highest, sumType)                                                        \
+  FIND_MIN_DEFINE_KERNEL(findMinBlocks##suffix, type, highest, 0)                                                      \
+  FIND_MIN_DEFINE_KERNEL(findMinBlocksUntil##suffix, type, highest, 1)                                                 \
+                                                                                                                       \
+  static type (* kernel##suffix)(type const *, size_t, type) = findMinBlocks##suffix;                                  \
+  static type (* kernelUntil##suffix)(type const *, size_t, type) = findMinBlocksUntil##suffix;                        \
+                                                                                                                       \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    type const * data;                                                                                                 \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+    size_t chunkSize;                                                                                                  \
+    type sentinel;                                                                                                     \
+    int stopOnSentinel;                                                                                                \
+    int * stop;                                                                                                        \
+    type minimum;                                                                                                      \
+    int threaded;                                                                                                      \
+    pthread_t thread;                                                                                                  \
+  } FindMinSlice##suffix;                                                                                              \
+                                                                                                                       \
+  static void * searchSlice##suffix(void * slice)                                                                      \
+  {                                                                                                                    \
+    FindMinSlice##suffix * s = (FindMinSlice##suffix *) slice;                                                         \
+    type min = highest;                                                                                                \
+    size_t i;                                                                                                          \
+    for (i = s->begin; i < s->end; i += s->chunkSize)                                                                  \
+    {                                                                                                                  \
+      size_t size = s->end - i < s->chunkSize ? s->end - i : s->chunkSize;                                             \
+      type chunkMin;                                                                                                   \
+      if (s->stopOnSentinel)                                                                                           \
+      {                                                                                                                \
+        if (__atomic_load_n(s->stop, __ATOMIC_RELAXED)) break;                                                         \
+        chunkMin = kernelUntil##suffix(s->data + i, size, s->sentinel);                                                \
+      }                                                                                                                \
+      else                                                                                                             \
+      {                                                                                                                \
+        chunkMin = kernel##suffix(s->data + i, size, lowest);                                                          \
+      }                                                                                                                \
+      if (chunkMin < min)                                                                                              \
+      {                                                                                                                \
+        min = chunkMin;                                                                                                \
+      }                                                                                                                \
+      if (s->stopOnSentinel && min <= s->sentinel)                                                                     \
+      {                                                                                                                \
+        __atomic_store_n(s->stop, 1, __ATOMIC_RELAXED);                                                                \
+        break;                                                                                                         \
+      }                                                                                                                \
+    }                                                                                                                  \
+    s->minimum = min;                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  static type search##suffix(type const * data, size_t size, type sentinel, int stopOnSentinel,                        \
+                             FindMinOptions const * options)                                                           \
+  {                                                                                                                    \
+    size_t chunkSize = options && options->chunkSize ? options->chunkSize : FIND_MIN_DEFAULT_CHUNK_SIZE;               \
+    size_t threadCount = resolveThreadCount(options, size, chunkSize);                                                 \
+    FindMinSlice##suffix onlySlice;                                                                                    \
+    FindMinSlice##suffix * slices = &onlySlice;                                                                        \
+    if (threadCount > 1)                                                                                               \
+    {                                                                                                                  \
+      slices = (FindMinSlice##suffix *) malloc(threadCount * sizeof(FindMinSlice##suffix));                            \
+      if (!slices)                                                                                                     \
+      {                                                                                                                \
+        slices = &onlySlice;                                                                                           \
+        threadCount = 1;                                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    int stop = 0;                                                                                                      \
+    size_t i;                                                                                                          \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      slices[i].data = data;                                                                                           \
+      slices[i].begin = size * i / threadCount;                                                                        \
+      slices[i].end = size * (i + 1) / threadCount;                                                                    \
+      slices[i].chunkSize = chunkSize;                                                                                 \
+      slices[i].sentinel = sentinel;                                                                                   \
+      slices[i].stopOnSentinel = stopOnSentinel;                                                                       \
+      slices[i].stop = &stop;                                                                                          \
+      /* The calling thread searches the first slice, and any slice a thread could not be created for */               \
+      slices[i].threaded = i > 0 && pthread_create(&slices[i].thread, NULL, searchSlice##suffix, &slices[i]) == 0;     \
+    }                                                                                                                  \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      if (!slices[i].threaded)                                                                                         \
+      {                                                                                                                \
+        searchSlice##suffix(&slices[i]);                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    type min = highest;                                                                                                \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      if (slices[i].threaded)                                                                                          \
+      {                                                                                                                \
+        pthread_join(slices[i].thread, NULL);                                                                          \
+      }                                                                                                                \
+      if (slices[i].minimum < min)                                                                                     \
+      {                                                                                                                \
+        min = slices[i].minimum;                                                                                       \
+      }                                                                                                                \
+    }                                                                                                                  \
+    if (slices != &onlySlice)                                                                                          \
+    {                                                                                                                  \
+      free(slices);                                                                                                    \
+    }                                                                                                                  \
+    return min;                                                                                                        \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMin##suffix(type const * data, size_t size, FindMinOptions const * options)                                 \
+  {                                                                                                                    \
+    return search##suffix(data, size, lowest, 0, options);                                                             \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinKernel##suffix(type const * data, size_t size)                                                           \
+  {                                                                                                                    \
+    return kernel##suffix(data, size, lowest);                                                                         \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinKernelUntil##suffix(type const * data, size_t size, type sentinel)                                       \
+  {                                                                                                                    \
+    return kernelUntil##suffix(data, size, sentinel);                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinUntil##suffix(type const * data, size_t size, type sentinel, FindMinOptions const * options)             \
+  {                                                                                                                    \
+    return search##suffix(data, size, sentinel, 1, options);                                                           \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE)
+
+/**
+ * Defines `findArgMin<Type>()` and `findSmallest<Type>()` for one element type, along with:
+ * `SmallestSlice<Type>`, the part of the search done by one thread. `values` and `indices` hold `2 * k` entries: the
+ * slice's result in the first `k` (the first `count` of them in use), and scratch space for merging in the rest.
+ * `slices`, `self` and `sliceCount` locate the slice among the others, for merging.
+ * `scanArgMin<Type>()`, which finds a slice's minimum and its lowest index a chunk at a time with `kernel<Type>`, only
+ * rescanning a chunk to locate its minimum when the minimum improves - so it costs about as much as a plain min scan.
+ * `scanSmallest<Type>()`, which keeps a slice's `k` smallest elements in a max-heap (skipping whole blocks of
+ * `FIND_MIN_SELECT_BLOCK_SIZE` elements that `kernel<Type>` shows have nothing smaller than its top), then sorts them.
+ * `searchSmallestSlice<Type>()`, which searches a slice and then merges its neighbours' results into its own, as a
+ * binary tree: slice `i` merges slice `i + 1`, `i + 2`, `i + 4`... for as long as `i` is a multiple of twice the step.
+ */
+#define FIND_MIN_DEFINE_SMALLEST(suffix, type, lowest, highest, sumType)                                               \
+  typedef struct SmallestSlice##suffix                                                                                 \
+  {                                                                                                                    \
+    type const * data;                                                                                                 \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+    size_t chunkSize;                                                                                                  \
+    size_t k;                                                                                                          \
+    type * values;                                                                                                     \
+    size_t * indices;                                                                                                  \
+    size_t count;                                                                                                      \
+    struct SmallestSlice##suffix * slices;                                                                             \
+    size_t self;                                                                                                       \
+    size_t sliceCount;                                                                                                 \
+    int threaded;                                                                                                      \
+    pthread_t thread;                                                                                                  \
+  } SmallestSlice##suffix;                                                                                             \
+                                                                                                                       \
+  static int before##suffix(type a, size_t aIndex, type b, size_t bIndex)                                              \
+  {                                                                                                                    \
+    return a < b || (a == b && aIndex < bIndex);                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void siftDown##suffix(type * values, size_t * indices, size_t count, size_t i)                                \
+  {                                                                                                                    \
+    for (;;)                                                                                                           \
+    {                                                                                                                  \
+      size_t largest = i;                                                                                              \
+      size_t child;                                                                                                    \
+      for (child = 2 * i + 1; child <= 2 * i + 2 && child < count; ++child)                                            \
+      {                                                                                                                \
+        if (before##suffix(values[largest], indices[largest], values[child], indices[child]))                          \
+        {                                                                                                              \
+          largest = child;                                                                                             \
+        }                                                                                                              \
+      }                                                                                                                \
+      if (largest == i) return;                                                                                        \
+      type value = values[i];                                                                                          \
+      size_t index = indices[i];                                                                                       \
+      values[i] = values[largest];                                                                                     \
+      indices[i] = indices[largest];                                                                                   \
+      values[largest] = value;                                                                                         \
+      indices[largest] = index;                                                                                        \
+      i = largest;                                                                                                     \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void pushHeap##suffix(type * values, size_t * indices, size_t count, type value, size_t index)                \
+  {                                                                                                                    \
+    size_t i = count;                                                                                                  \
+    while (i > 0 && before##suffix(values[(i - 1) / 2], indices[(i - 1) / 2], value, index))                           \
+    {                                                                                                                  \
+      values[i] = values[(i - 1) / 2];                                                                                 \
+      indices[i] = indices[(i - 1) / 2];                                                                               \
+      i = (i - 1) / 2;                                                                                                 \
+    }                                                                                                                  \
+    values[i] = value;                                                                                                 \
+    indices[i] = index;                                                                                                \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void scanArgMin##suffix(SmallestSlice##suffix * s)                                                            \
+  {                                                                                                                    \
+    type min = highest;                                                                                                \
+    size_t minIndex = SIZE_MAX;                                                                                        \
+    size_t i;                                                                                                          \
+    for (i = s->begin; i < s->end; i += s->chunkSize)                                                                  \
+    {                                                                                                                  \
+      size_t end = s->end - i < s->chunkSize ? s->end : i + s->chunkSize;                                              \
+      type chunkMin = kernel##suffix(s->data + i, end - i, lowest);                                                    \
+      if (chunkMin < min || minIndex == SIZE_MAX)                                                                      \
+      {                                                                                                                \
+        size_t j;                                                                                                      \
+        for (j = i; j < end && !(s->data[j] == chunkMin); ++j)                                                         \
+        {                                                                                                              \
+        }                                                                                                              \
+        if (j < end)                                                                                                   \
+        {                                                                                                              \
+          min = chunkMin;                                                                                              \
+          minIndex = j;                                                                                                \
+        }                                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    s->count = minIndex != SIZE_MAX;                                                                                   \
+    s->values[0] = min;                                                                                                \
+    s->indices[0] = minIndex;                                                                                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void scanSmallest##suffix(SmallestSlice##suffix * s)                                                          \
+  {                                                                                                                    \
+    type * values = s->values;                                                                                         \
+    size_t * indices = s->indices;                                                                                     \
+    size_t count = 0;                                                                                                  \
+    size_t i = s->begin;                                                                                               \
+    while (i < s->end)                                                                                                 \
+    {                                                                                                                  \
+      size_t end = s->end - i < FIND_MIN_SELECT_BLOCK_SIZE ? s->end : i + FIND_MIN_SELECT_BLOCK_SIZE;                  \
+      if (count == s->k && !(kernel##suffix(s->data + i, end - i, lowest) < values[0]))                                \
+      {                                                                                                                \
+        i = end;                                                                                                       \
+        continue;                                                                                                      \
+      }                                                                                                                \
+      for (; i < end; ++i)                                                                                             \
+      {                                                                                                                \
+        type value = s->data[i];                                                                                       \
+        if (count < s->k)                                                                                              \
+        {                                                                                                              \
+          if (value == value)                                                                                          \
+          {                                                                                                            \
+            pushHeap##suffix(values, indices, count++, value, i);                                                      \
+          }                                                                                                            \
+        }                                                                                                              \
+        else if (value < values[0])                                                                                    \
+        {                                                                                                              \
+          values[0] = value;                                                                                           \
+          indices[0] = i;                                                                                              \
+          siftDown##suffix(values, indices, count, 0);                                                                 \
+        }                                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    s->count = count;                                                                                                  \
+    while (count > 1)                                                                                                  \
+    {                                                                                                                  \
+      --count;                                                                                                         \
+      type value = values[0];                                                                                          \
+      size_t index = indices[0];                                                                                       \
+      values[0] = values[count];                                                                                       \
+      indices[0] = indices[count];                                                                                     \
+      values[count] = value;                                                                                           \
+      indices[count] = index;                                                                                          \
+      siftDown##suffix(values, indices, count, 0);                                                                     \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void mergeSmallest##suffix(SmallestSlice##suffix * into, SmallestSlice##suffix const * from)                  \
+  {                                                                                                                    \
+    type * values = into->values + into->k;                                                                            \
+    size_t * indices = into->indices + into->k;                                                                        \
+    size_t a = 0;                                                                                                      \
+    size_t b = 0;                                                                                                      \
+    size_t count = 0;                                                                                                  \
+    while (count < into->k && (a < into->count || b < from->count))                                                    \
+    {                                                                                                                  \
+      if (b == from->count ||                                                                                          \
+          (a < into->count && before##suffix(into->values[a], into->indices[a], from->values[b], from->indices[b])))   \
+      {                                                                                                                \
+        values[count] = into->values[a];                                                                               \
+        indices[count++] = into->indices[a++];                                                                         \
+      }                                                                                                                \
+      else                                                                                                             \
+      {                                                                                                                \
+        values[count] = from->values[b];                                                                               \
+        indices[count++] = from->indices[b++];                                                                         \
+      }                                                                                                                \
+    }                                                                                                                  \
+    memcpy(into->values, values, count * sizeof(type));                                                                \
+    memcpy(into->indices, indices, count * sizeof(size_t));                                                            \
+    into->count = count;                                                                                               \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void * searchSmallestSlice##suffix(void * slice)                                                              \
+  {                                                                                                                    \
+    SmallestSlice##suffix * s = (SmallestSlice##suffix *) slice;                                                       \
+    if (s->k == 1)                                                                                                     \
+    {                                                                                                                  \
+      scanArgMin##suffix(s);                                                                                           \
+    }                                                                                                                  \
+    else                                                                                                               \
+    {                                                                                                                  \
+      scanSmallest##suffix(s);                                                                                         \
+    }                                                                                                                  \
+    size_t step;                                                                                                       \
+    for (step = 1; s->self % (2 * step) == 0 && s->self + step < s->sliceCount; step *= 2)                             \
+    {                                                                                                                  \
+      SmallestSlice##suffix * partner = &s->slices[s->self + step];                                                    \
+      if (partner->threaded)                                                                                           \
+      {                                                                                                                \
+        pthread_join(partner->thread, NULL);                                                                           \
+      }                                                                                                                \
+      else                                                                                                             \
+      {                                                                                                                \
+        searchSmallestSlice##suffix(partner);                                                                          \
+      }                                                                                                                \
+      mergeSmallest##suffix(s, partner);                                                                               \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  size_t findArgMin##suffix(type const * data, size_t size, FindMinOptions const * options)                            \
+  {                                                                                                                    \
+    type value;                                                                                                        \
+    size_t index;                                                                                                      \
+    return findSmallest##suffix(data, size, 1, &value, &index, options) ? index : SIZE_MAX;                            \
+  }                                                                                                                    \
+                                                                                                                       \
+  size_t findSmallest##suffix(type const * data, size_t size, size_t k, type * values, size_t * indices,               \
+                              FindMinOptions const * options)                                                          \
+  {                                                                                                                    \
+    if (k == 0 || size == 0) return 0;                                                                                 \
+    size_t chunkSize = options && options->chunkSize ? options->chunkSize : FIND_MIN_DEFAULT_CHUNK_SIZE;               \
+    size_t threadCount = resolveThreadCount(options, size, chunkSize);                                                 \
+    k = k < size ? k : size;                                                                                           \
+    /* Each slice holds `2 * k` values and `2 * k` indices */                                                          \
+    if (k > SIZE_MAX / 2 / threadCount / (sizeof(type) > sizeof(size_t) ? sizeof(type) : sizeof(size_t))) return 0;    \
+    SmallestSlice##suffix * slices = (SmallestSlice##suffix *) malloc(threadCount * sizeof(SmallestSlice##suffix));    \
+    type * sliceValues = (type *) malloc(threadCount * 2 * k * sizeof(type));                                          \
+    size_t * sliceIndices = (size_t *) malloc(threadCount * 2 * k * sizeof(size_t));                                   \
+    size_t count = 0;                                                                                                  \
+    if (slices && sliceValues && sliceIndices)                                                                         \
+    {                                                                                                                  \
+      size_t i;                                                                                                        \
+      for (i = threadCount; i-- > 0;)                                                                                  \
+      {                                                                                                                \
+        slices[i].data = data;                                                                                         \
+        slices[i].begin = size * i / threadCount;                                                                      \
+        slices[i].end = size * (i + 1) / threadCount;                                                                  \
+        slices[i].chunkSize = chunkSize;                                                                               \
+        slices[i].k = k;                                                                                               \
+        slices[i].values = sliceValues + i * 2 * k;                                                                    \
+        slices[i].indices = sliceIndices + i * 2 * k;                                                                  \
+        slices[i].slices = slices;                                                                                     \
+        slices[i].self = i;                                                                                            \
+        slices[i].sliceCount = threadCount;                                                                            \
+        /* Slices are started from the last, so each slice's merge partners exist before it does */                    \
+        slices[i].threaded =                                                                                           \
+          i > 0 && pthread_create(&slices[i].thread, NULL, searchSmallestSlice##suffix, &slices[i]) == 0;              \
+      }                                                                                                                \
+      searchSmallestSlice##suffix(&slices[0]);                                                                         \
+      count = slices[0].count;                                                                                         \
+      memcpy(values, slices[0].values, count * sizeof(type));                                                          \
+      memcpy(indices, slices[0].indices, count * sizeof(size_t));                                                      \
+    }                                                                                                                  \
+    free(slices);                                                                                                      \
+    free(sliceValues);                                                                                                 \
+    free(sliceIndices);                                                                                                \
+    return count;                                                                                                      \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE_SMALLEST)
+
+/**
+ * Lists `X(suffix, type, lowest, sumType, statistics)` for each non-empty combination `statistics` of the
+ * `FIND_MIN_REDUCE_SCALARS`, as a literal that can be pasted into a name.
+ */
+#define FIND_MIN_REDUCE_COMBINATIONS(X, suffix, type, lowest, sumType)                                                 \
+  X(suffix, type, lowest, sumType, 1) X(suffix, type, lowest, sumType, 2) X(suffix, type, lowest, sumType, 3)          \
+  X(suffix, type, lowest, sumType, 4) X(suffix, type, lowest, sumType, 5) X(suffix, type, lowest, sumType, 6)          \
+  X(suffix, type, lowest, sumType, 7) X(suffix, type, lowest, sumType, 8) X(suffix, type, lowest, sumType, 9)          \
+  X(suffix, type, lowest, sumType, 10) X(suffix, type, lowest, sumType, 11) X(suffix, type, lowest, sumType, 12)       \
+  X(suffix, type, lowest, sumType, 13) X(suffix, type, lowest, sumType, 14) X(suffix, type, lowest, sumType, 15)
+
+// The name of the function `FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_DEFINE_REDUCE_BLOCK, ...)` defines for `statistics`
+#define FIND_MIN_REDUCE_BLOCK_NAME(suffix, type, lowest, sumType, statistics) reduceBlock##suffix##With##statistics,
+
+/**
+ * Defines `reduceBlock<Type>With<statistics>()`, which folds the `size` elements at `block` into the partial results
+ * of `s`: only the statistics in `statistics`, a constant, so the loop over the block computes nothing else and
+ * vectorizes as tightly as it can. The minimum alone is left to `kernel<Type>`.
+ */
+#define FIND_MIN_DEFINE_REDUCE_BLOCK(suffix, type, lowest, sumType, statistics)                                        \
+  FIND_MIN_TARGET_CLONES                                                                                               \
+  static void reduceBlock##suffix##With##statistics(type const * block, size_t size, type threshold,                   \
+                                                    ReduceSlice##suffix * s)                                           \
+  {                                                                                                                    \
+    type min = s->minimum;                                                                                             \
+    type max = s->maximum;                                                                                             \
+    sumType sum = s->sum;                                                                                              \
+    uint32_t countBelow = 0;                                                                                           \
+    size_t i;                                                                                                          \
+    (void) threshold;                                                                                                  \
+    if ((statistics) == FIND_MIN_MINIMUM)                                                                              \
+    {                                                                                                                  \
+      type blockMin = kernel##suffix(block, size, lowest);                                                             \
+      s->minimum = blockMin < min ? blockMin : min;                                                                    \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    for (i = 0; i < size; ++i)                                                                                         \
+    {                                                                                                                  \
+      if ((statistics) & FIND_MIN_MINIMUM) min = block[i] < min ? block[i] : min;                                      \
+      if ((statistics) & FIND_MIN_MAXIMUM) max = block[i] > max ? block[i] : max;                                      \
+      if ((statistics) & FIND_MIN_SUM) sum += block[i];                                                                \
+      if ((statistics) & FIND_MIN_COUNT_BELOW) countBelow += block[i] < threshold;                                     \
+    }                                                                                                                  \
+    s->minimum = min;                                                                                                  \
+    s->maximum = max;                                                                                                  \
+    s->sum = sum;                                                                                                      \
+    s->countBelow += countBelow;                                                                                       \
+  }
+
+/**
+ * Defines `findMinReduce<Type>()` for one element type, along with:
+ * `ReduceSlice<Type>`, the part of a reduction done by one thread, with its partial results. `bins` is the thread's own
+ * histogram: `FIND_MIN_HISTOGRAM_COPIES` copies of `binCount + 1` counters (the last for elements out of range), which
+ * consecutive elements are counted into in turn so that repeated elements do not serialize on one counter. The copies
+ * are summed into the first `binCount` counters once the slice is done. `binCount` is 0 if no histogram is computed.
+ * Integer elements are binned exactly, by their offset from `histogramLow`. If the range times `binCount` is at most
+ * 2^30 (`binExact`), that is done in fixed point, with no conversion or division: the offset times `binMultiplier`,
+ * shifted right by `binPrecision`. `binMultiplier` is the number of bins per unit of offset, scaled by
+ * `2^binPrecision` to between 2^30 and 2^31 and rounded up, which is then exact. Wider ranges are binned by
+ * `exactBin()`.
+ * Floating-point elements are binned in `double`, scaled by `binScale`.
+ * `reduceBlocks<Type>`, the `reduceBlock<Type>With<statistics>()` for each combination of the minimum, maximum, sum
+ * and count, indexed by it, and `binKernel<Type>`, which computes the bin indices of a block (in 32-bit lanes for
+ * integer types that fit) - the `int32_t` ones are replaced by SIMD kernels by `selectKernels()`.
+ * `reduceSlice<Type>()`, which reduces a slice in blocks of `FIND_MIN_REDUCE_BLOCK_SIZE` elements, so memory is
+ * streamed through once however many statistics are computed: the block function for the requested statistics runs
+ * over each block, then the histogram while the block is still in the L1 cache, its bin indices computed in one loop
+ * and counted in a second.
+ * The partial results are combined by the calling thread once it has joined the others.
+ */
+#define FIND_MIN_DEFINE_REDUCE(suffix, type, lowest, highest, sumType)                                                 \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    type const * data;                                                                                                 \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+    FindMinReduction##suffix const * reduction;                                                                        \
+    type minimum;                                                                                                      \
+    type maximum;                                                                                                      \
+    sumType sum;                                                                                                       \
+    size_t countBelow;                                                                                                 \
+    size_t binCount;                                                                                                   \
+    uint64_t binSpan;                                                                                                  \
+    uint32_t binMultiplier;                                                                                            \
+    unsigned binPrecision;                                                                                             \
+    int binExact;                                                                                                      \
+    double binScale;                                                                                                   \
+    size_t * bins;                                                                                                     \
+    int threaded;                                                                                                      \
+    pthread_t thread;                                                                                                  \
+  } ReduceSlice##suffix;                                                                                               \
+                                                                                                                       \
+  FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_DEFINE_REDUCE_BLOCK, suffix, type, lowest, sumType)                            \
+                                                                                                                       \
+  static void (* reduceBlocks##suffix[FIND_MIN_REDUCE_SCALARS + 1])(type const *, size_t, type,                        \
+                                                                   ReduceSlice##suffix *) = {                          \
+    NULL, FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_REDUCE_BLOCK_NAME, suffix, type, lowest, sumType)                      \
+  };                                                                                                                   \
+                                                                                                                       \
+  FIND_MIN_TARGET_CLONES                                                                                               \
+  static void computeBins##suffix(type const * block, size_t size, ReduceSlice##suffix const * s,                      \
+                                  uint32_t * binIndices)                                                               \
+  {                                                                                                                    \
+    type histogramLow = s->reduction->histogramLow;                                                                    \
+    uint32_t outOfRange = (uint32_t) s->binCount;                                                                      \
+    uint64_t span = s->binSpan;                                                                                        \
+    uint32_t multiplier = s->binMultiplier;                                                                            \
+    unsigned precision = s->binPrecision;                                                                              \
+    double scale = s->binScale;                                                                                        \
+    double limit = (double) s->binCount;                                                                               \
+    size_t i;                                                                                                          \
+    if (FIND_MIN_IS_INTEGER(type) && !s->binExact)                                                                     \
+    {                                                                                                                  \
+      for (i = 0; i < size; ++i)                                                                                       \
+      {                                                                                                                \
+        uint64_t offset = (uint64_t) block[i] - (uint64_t) histogramLow;                                               \
+        binIndices[i] = offset <= span ? exactBin(offset, outOfRange, span + 1) : outOfRange;                          \
+      }                                                                                                                \
+    }                                                                                                                  \
+    else if (FIND_MIN_IS_INTEGER(type) && sizeof(type) <= sizeof(uint32_t))                                            \
+    {                                                                                                                  \
+      for (i = 0; i < size; ++i)                                                                                       \
+      {                                                                                                                \
+        /* Elements below `histogramLow` wrap around to offsets past `span` */                                         \
+        uint32_t offset = (uint32_t) block[i] - (uint32_t) histogramLow;                                               \
+        uint32_t bin = (uint32_t) ((uint64_t) offset * multiplier >> precision);                                       \
+        binIndices[i] = offset <= (uint32_t) span ? bin : outOfRange;                                                  \
+      }                                                                                                                \
+    }                                                                                                                  \
+    else if (FIND_MIN_IS_INTEGER(type))                                                                                \
+    {                                                                                                                  \
+      for (i = 0; i < size; ++i)                                                                                       \
+      {                                                                                                                \
+        uint64_t offset = (uint64_t) block[i] - (uint64_t) histogramLow;                                               \
+        uint32_t bin = (uint32_t) ((uint64_t) (uint32_t) offset * multiplier >> precision);                            \
+        binIndices[i] = offset <= span ? bin : outOfRange;                                                             \
+      }                                                                                                                \
+    }                                                                                                                  \
+    else                                                                                                               \
+    {                                                                                                                  \
+      for (i = 0; i < size; ++i)                                                                                       \
+      {                                                                                                                \
+        double offset = ((double) block[i] - (double) histogramLow) * scale;                                           \
+        binIndices[i] = offset >= 0 && offset < limit ? (uint32_t) (int32_t) offset : outOfRange;                      \
+      }                                                                                                                \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void (* binKernel##suffix)(type const *, size_t, ReduceSlice##suffix const *, uint32_t *) =                   \
+    computeBins##suffix;                                                                                               \
+                                                                                                                       \
+  static void * reduceSlice##suffix(void * slice)                                                                      \
+  {                                                                                                                    \
+    ReduceSlice##suffix * s = (ReduceSlice##suffix *) slice;                                                           \
+    FindMinReduction##suffix const * r = s->reduction;                                                                 \
+    void (* reduceBlock)(type const *, size_t, type, ReduceSlice##suffix *) =                                          \
+      reduceBlocks##suffix[r->statistics & FIND_MIN_REDUCE_SCALARS];                                                   \
+    size_t binCount = s->binCount;                                                                                     \
+    size_t binStride = binCount + 1;                                                                                   \
+    size_t * bins = s->bins;                                                                                           \
+    uint32_t binIndices[FIND_MIN_REDUCE_BLOCK_SIZE];                                                                   \
+    s->binSpan = 0;                                                                                                    \
+    s->binMultiplier = 0;                                                                                              \
+    s->binPrecision = 0;                                                                                               \
+    s->binExact = 0;                                                                                                   \
+    s->binScale = (double) binCount / ((double) r->histogramHigh - (double) r->histogramLow);                          \
+    if (binCount > 0 && FIND_MIN_IS_INTEGER(type))                                                                     \
+    {                                                                                                                  \
+      s->binSpan = (uint64_t) r->histogramHigh - (uint64_t) r->histogramLow - 1;                                       \
+      uint64_t range = s->binSpan + 1;                                                                                 \
+      s->binExact = range <= ((uint64_t) 1 << 30) / binCount;                                                          \
+      while (s->binExact && ((uint64_t) binCount << s->binPrecision) / range < (uint64_t) 1 << 30)                     \
+      {                                                                                                                \
+        ++s->binPrecision;                                                                                             \
+      }                                                                                                                \
+      uint64_t scaledCount = (uint64_t) binCount << s->binPrecision;                                                   \
+      s->binMultiplier = s->binExact ? (uint32_t) (scaledCount / range + (scaledCount % range != 0)) : 0;              \
+    }                                                                                                                  \
+    s->minimum = highest;                                                                                              \
+    s->maximum = lowest;                                                                                               \
+    s->sum = 0;                                                                                                        \
+    s->countBelow = 0;                                                                                                 \
+    size_t i;                                                                                                          \
+    for (i = s->begin; i < s->end; i += FIND_MIN_REDUCE_BLOCK_SIZE)                                                    \
+    {                                                                                                                  \
+      type const * block = s->data + i;                                                                                \
+      size_t size = s->end - i < FIND_MIN_REDUCE_BLOCK_SIZE ? s->end - i : FIND_MIN_REDUCE_BLOCK_SIZE;                 \
+      size_t j;                                                                                                        \
+      /* Fetches the next block while this one is reduced, as the block functions do too little to hide the latency */ \
+      size_t prefetchEnd = s->end - i < 2 * FIND_MIN_REDUCE_BLOCK_SIZE ? s->end - i : 2 * FIND_MIN_REDUCE_BLOCK_SIZE;  \
+      for (j = FIND_MIN_REDUCE_BLOCK_SIZE; j < prefetchEnd; j += 64 / sizeof(type))                                    \
+      {                                                                                                                \
+        __builtin_prefetch(block + j);                                                                                 \
+      }                                                                                                                \
+      if (reduceBlock)                                                                                                 \
+      {                                                                                                                \
+        reduceBlock(block, size, r->threshold, s);                                                                     \
+      }                                                                                                                \
+      if (binCount == 0) continue;                                                                                     \
+      binKernel##suffix(block, size, s, binIndices);                                                                   \
+      for (j = 0; j + FIND_MIN_HISTOGRAM_COPIES <= size; j += FIND_MIN_HISTOGRAM_COPIES)                               \
+      {                                                                                                                \
+        ++bins[binIndices[j]];                                                                                         \
+        ++bins[binStride + binIndices[j + 1]];                                                                         \
+        ++bins[2 * binStride + binIndices[j + 2]];                                                                     \
+        ++bins[3 * binStride + binIndices[j + 3]];                                                                     \
+      }                                                                                                                \
+      for (; j < size; ++j)                                                                                            \
+      {                                                                                                                \
+        ++bins[binIndices[j]];                                                                                         \
+      }                                                                                                                \
+    }                                                                                                                  \
+    if (binCount > 0)                                                                                                  \
+    {                                                                                                                  \
+      size_t copy;                                                                                                     \
+      for (copy = 1; copy < FIND_MIN_HISTOGRAM_COPIES; ++copy)                                                         \
+      {                                                                                                                \
+        size_t bin;                                                                                                    \
+        for (bin = 0; bin < binCount; ++bin)                                                                           \
+        {                                                                                                              \
+          bins[bin] += bins[copy * binStride + bin];                                                                   \
+        }                                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinReduce##suffix(type const * data, size_t size, FindMinReduction##suffix * reduction,                     \
+                             FindMinOptions const * options)                                                           \
+  {                                                                                                                    \
+    size_t chunkSize = options && options->chunkSize ? options->chunkSize : FIND_MIN_DEFAULT_CHUNK_SIZE;               \
+    size_t threadCount = resolveThreadCount(options, size, chunkSize);                                                 \
+    size_t binCount = reduction->statistics & FIND_MIN_HISTOGRAM ? reduction->binCount : 0;                            \
+    if (binCount > 0)                                                                                                  \
+    {                                                                                                                  \
+      memset(reduction->bins, 0, binCount * sizeof(size_t));                                                           \
+    }                                                                                                                  \
+    if (!(reduction->histogramLow < reduction->histogramHigh))                                                         \
+    {                                                                                                                  \
+      binCount = 0;                                                                                                    \
+    }                                                                                                                  \
+    ReduceSlice##suffix onlySlice;                                                                                     \
+    ReduceSlice##suffix * slices = &onlySlice;                                                                         \
+    size_t sliceBinCount = binCount > 0 ? FIND_MIN_HISTOGRAM_COPIES * (binCount + 1) : 0;                              \
+    if (threadCount > 1)                                                                                               \
+    {                                                                                                                  \
+      slices = (ReduceSlice##suffix *) malloc(threadCount * sizeof(ReduceSlice##suffix));                              \
+      if (!slices)                                                                                                     \
+      {                                                                                                                \
+        slices = &onlySlice;                                                                                           \
+        threadCount = 1;                                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    size_t * sliceBins = (size_t *) calloc(threadCount * sliceBinCount + 1, sizeof(size_t));                           \
+    if (!sliceBins)                                                                                                    \
+    {                                                                                                                  \
+      binCount = 0;                                                                                                    \
+    }                                                                                                                  \
+    size_t i;                                                                                                          \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      slices[i].data = data;                                                                                           \
+      slices[i].begin = size * i / threadCount;                                                                        \
+      slices[i].end = size * (i + 1) / threadCount;                                                                    \
+      slices[i].reduction = reduction;                                                                                 \
+      slices[i].binCount = binCount;                                                                                   \
+      slices[i].bins = sliceBins + i * sliceBinCount;                                                                  \
+      slices[i].threaded = i > 0 && pthread_create(&slices[i].thread, NULL, reduceSlice##suffix, &slices[i]) == 0;     \
+    }                                                                                                                  \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      if (!slices[i].threaded)                                                                                         \
+      {                                                                                                                \
+        reduceSlice##suffix(&slices[i]);                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    type min = highest;                                                                                                \
+    type max = lowest;                                                                                                 \
+    sumType sum = 0;                                                                                                   \
+    size_t countBelow = 0;                                                                                             \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      if (slices[i].threaded)                                                                                          \
+      {                                                                                                                \
+        pthread_join(slices[i].thread, NULL);                                                                          \
+      }                                                                                                                \
+      min = slices[i].minimum < min ? slices[i].minimum : min;                                                         \
+      max = slices[i].maximum > max ? slices[i].maximum : max;                                                         \
+      sum += slices[i].sum;                                                                                            \
+      countBelow += slices[i].countBelow;                                                                              \
+      size_t bin;                                                                                                      \
+      for (bin = 0; bin < binCount; ++bin)                                                                             \
+      {                                                                                                                \
+        reduction->bins[bin] += slices[i].bins[bin];                                                                   \
+      }                                                                                                                \
+    }                                                                                                                  \
+    if (reduction->statistics & FIND_MIN_MINIMUM) reduction->minimum = min;                                            \
+    if (reduction->statistics & FIND_MIN_MAXIMUM) reduction->maximum = max;                                            \
+    if (reduction->statistics & FIND_MIN_SUM) reduction->sum = sum;                                                    \
+    if (reduction->statistics & FIND_MIN_COUNT_BELOW) reduction->countBelow = countBelow;                              \
+    if (slices != &onlySlice)                                                                                          \
+    {                                                                                                                  \
+      free(slices);                                                                                                    \
+    }                                                                                                                  \
+    free(sliceBins);                                                                                                   \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE_REDUCE)
+
+/**
+ * Defines the range minimum query functions for one element type, along with:
+ * `RangeLevelSlice<Type>` and `buildRangeLevel<Type>()`, which compute the entries `[begin, end)` of one level of a
+ * `FindMinRangeIndex<Type>`'s table: the minima of single blocks (with `kernel<Type>`) for level 0, and the smaller of
+ * two overlapping entries of the level below for the others. Levels are built one after the other, each in parallel.
+ * `RangeQuerySlice<Type>` and `queryRanges<Type>()`, which answer the queries `[begin, end)` of a batch.
+ * A query scans the partial blocks at its edges with `kernel<Type>`, and looks the whole blocks in between up in the
+ * table as the minimum of two (possibly overlapping) runs of `2^level` blocks.
+ */
+#define FIND_MIN_DEFINE_RANGE(suffix, type, lowest, highest, sumType)                                                  \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    FindMinRangeIndex##suffix * index;                                                                                 \
+    size_t level;                                                                                                      \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+  } RangeLevelSlice##suffix;                                                                                           \
+                                                                                                                       \
+  static void * buildRangeLevel##suffix(void * slice)                                                                  \
+  {                                                                                                                    \
+    RangeLevelSlice##suffix * s = (RangeLevelSlice##suffix *) slice;                                                   \
+    FindMinRangeIndex##suffix * index = s->index;                                                                      \
+    type * row = index->table + s->level * index->blockCount;                                                          \
+    size_t i;                                                                                                          \
+    if (s->level == 0)                                                                                                 \
+    {                                                                                                                  \
+      for (i = s->begin; i < s->end; ++i)                                                                              \
+      {                                                                                                                \
+        row[i] = kernel##suffix(index->data + i * index->blockSize, index->blockSize, lowest);                         \
+      }                                                                                                                \
+    }                                                                                                                  \
+    else                                                                                                               \
+    {                                                                                                                  \
+      type const * previous = row - index->blockCount;                                                                 \
+      size_t half = (size_t) 1 << (s->level - 1);                                                                      \
+      for (i = s->begin; i < s->end; ++i)                                                                              \
+      {                                                                                                                \
+        row[i] = previous[i + half] < previous[i] ? previous[i + half] : previous[i];                                  \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    FindMinRangeIndex##suffix const * index;                                                                           \
+    size_t const * begins;                                                                                             \
+    size_t const * ends;                                                                                               \
+    type * minima;                                                                                                     \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+  } RangeQuerySlice##suffix;                                                                                           \
+                                                                                                                       \
+  static void * queryRanges##suffix(void * slice)                                                                      \
+  {                                                                                                                    \
+    RangeQuerySlice##suffix * s = (RangeQuerySlice##suffix *) slice;                                                   \
+    size_t i;                                                                                                          \
+    for (i = s->begin; i < s->end; ++i)                                                                                \
+    {                                                                                                                  \
+      s->minima[i] = findMinRange##suffix(s->index, s->begins[i], s->ends[i]);                                         \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  int findMinBuildRangeIndex##suffix(FindMinRangeIndex##suffix * index, type const * data, size_t size,                \
+                                     size_t blockSize, FindMinOptions const * options)                                 \
+  {                                                                                                                    \
+    index->data = data;                                                                                                \
+    index->size = size;                                                                                                \
+    index->blockSize = blockSize > 0 ? blockSize : FIND_MIN_DEFAULT_RANGE_BLOCK_SIZE;                                  \
+    index->blockCount = size / index->blockSize;                                                                       \
+    index->levelCount = 0;                                                                                             \
+    while (((size_t) 1 << index->levelCount) <= index->blockCount)                                                     \
+    {                                                                                                                  \
+      ++index->levelCount;                                                                                             \
+    }                                                                                                                  \
+    index->table = NULL;                                                                                               \
+    if (index->levelCount == 0) return 0;                                                                              \
+    index->table = (type *) malloc(index->levelCount * index->blockCount * sizeof(type));                              \
+    if (!index->table) return -1;                                                                                      \
+    size_t chunkSize = options && options->chunkSize ? options->chunkSize : FIND_MIN_DEFAULT_CHUNK_SIZE;               \
+    size_t maxThreadCount = resolveThreadCount(options, size, chunkSize);                                              \
+    RangeLevelSlice##suffix * slices = (RangeLevelSlice##suffix *) malloc(maxThreadCount * sizeof(*slices));           \
+    if (!slices)                                                                                                       \
+    {                                                                                                                  \
+      maxThreadCount = 0;                                                                                              \
+    }                                                                                                                  \
+    size_t level;                                                                                                      \
+    for (level = 0; level < index->levelCount; ++level)                                                                \
+    {                                                                                                                  \
+      RangeLevelSlice##suffix onlySlice;                                                                               \
+      size_t rowLength = index->blockCount - ((size_t) 1 << level) + 1;                                                \
+      /* Levels above the first are cheap to compute, so only large ones are split between threads */                  \
+      size_t threadCount = level == 0 ? maxThreadCount : rowLength / FIND_MIN_DEFAULT_CHUNK_SIZE;                      \
+      threadCount = threadCount < maxThreadCount ? threadCount : maxThreadCount;                                       \
+      threadCount = threadCount > 0 ? threadCount : 1;                                                                 \
+      RangeLevelSlice##suffix * levelSlices = slices ? slices : &onlySlice;                                            \
+      size_t i;                                                                                                        \
+      for (i = 0; i < threadCount; ++i)                                                                                \
+      {                                                                                                                \
+        levelSlices[i].index = index;                                                                                  \
+        levelSlices[i].level = level;                                                                                  \
+        levelSlices[i].begin = rowLength * i / threadCount;                                                            \
+        levelSlices[i].end = rowLength * (i + 1) / threadCount;                                                        \
+      }                                                                                                                \
+      runSlices(levelSlices, sizeof(*levelSlices), threadCount, buildRangeLevel##suffix);                              \
+    }                                                                                                                  \
+    free(slices);                                                                                                      \
+    return 0;                                                                                                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinFreeRangeIndex##suffix(FindMinRangeIndex##suffix * index)                                                \
+  {                                                                                                                    \
+    free(index->table);                                                                                                \
+    index->table = NULL;                                                                                               \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinRange##suffix(FindMinRangeIndex##suffix const * index, size_t begin, size_t end)                         \
+  {                                                                                                                    \
+    end = end < index->size ? end : index->size;                                                                       \
+    if (begin >= end) return highest;                                                                                  \
+    size_t firstBlock = (begin + index->blockSize - 1) / index->blockSize;                                             \
+    size_t endBlock = end / index->blockSize;                                                                          \
+    if (firstBlock >= endBlock) return kernel##suffix(index->data + begin, end - begin, lowest);                       \
+    type min = kernel##suffix(index->data + begin, firstBlock * index->blockSize - begin, lowest);                     \
+    type edge = kernel##suffix(index->data + endBlock * index->blockSize, end - endBlock * index->blockSize, lowest);  \
+    min = edge < min ? edge : min;                                                                                     \
+    size_t level = floorLog2(endBlock - firstBlock);                                                                   \
+    type const * row = index->table + level * index->blockCount;                                                       \
+    min = row[firstBlock] < min ? row[firstBlock] : min;                                                               \
+    size_t last = endBlock - ((size_t) 1 << level);                                                                    \
+    return row[last] < min ? row[last] : min;                                                                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinRanges##suffix(FindMinRangeIndex##suffix const * index, size_t const * begins, size_t const * ends,      \
+                             size_t count, type * minima, FindMinOptions const * options)                              \
+  {                                                                                                                    \
+    size_t threadCount = resolveThreadCount(options, count, FIND_MIN_RANGE_QUERY_CHUNK_SIZE);                          \
+    RangeQuerySlice##suffix onlySlice;                                                                                 \
+    RangeQuerySlice##suffix * slices = &onlySlice;                                                                     \
+    if (threadCount > 1)                                                                                               \
+    {                                                                                                                  \
+      slices = (RangeQuerySlice##suffix *) malloc(threadCount * sizeof(RangeQuerySlice##suffix));                      \
+      if (!slices)                                                                                                     \
+      {                                                                                                                \
+        slices = &onlySlice;                                                                                           \
+        threadCount = 1;                                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    size_t i;                                                                                                          \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      slices[i].index = index;                                                                                         \
+      slices[i].begins = begins;                                                                                       \
+      slices[i].ends = ends;                                                                                           \
+      slices[i].minima = minima;                                                                                       \
+      slices[i].begin = count * i / threadCount;                                                                       \
+      slices[i].end = count * (i + 1) / threadCount;                                                                   \
+    }                                                                                                                  \
+    runSlices(slices, sizeof(*slices), threadCount, queryRanges##suffix);                                              \
+    if (slices != &onlySlice)                                                                                          \
+    {                                                                                                                  \
+      free(slices);                                                                                                    \
+    }                                                                                                                  \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE_RANGE)
+
+/**
+ * Defines the min tree functions for one element type, along with:
+ * `computeTreeNode<Type>()`, which returns the minimum of the children of node `node` of `level` - the elements of
+ * its block of `data` for a leaf.
+ * `TreeLevelSlice<Type>` and `computeTreeLevel<Type>()`, which recompute the nodes `[begin, end)` of one level - only
+ * those marked dirty if `onlyDirty` is set, in which case the parents of the nodes that changed are marked in turn.
+ * `computeTreeLevels<Type>()`, which recomputes every level in parallel, from the leaves up.
+ */
+#define FIND_MIN_DEFINE_TREE(suffix, type, lowest, highest, sumType)                                                   \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    FindMinTree##suffix * tree;                                                                                        \
+    size_t level;                                                                                                      \
+    size_t begin;                                                                                                      \
+    size_t end;                                                                                                        \
+    int onlyDirty;                                                                                                     \
+  } TreeLevelSlice##suffix;                                                                                            \
+                                                                                                                       \
+  static type computeTreeNode##suffix(FindMinTree##suffix const * tree, size_t level, size_t node)                     \
+  {                                                                                                                    \
+    if (level == 0)                                                                                                    \
+    {                                                                                                                  \
+      size_t begin = node * FIND_MIN_TREE_LEAF_SIZE;                                                                   \
+      size_t size = tree->size - begin < FIND_MIN_TREE_LEAF_SIZE ? tree->size - begin : FIND_MIN_TREE_LEAF_SIZE;       \
+      return kernel##suffix(tree->data + begin, size, lowest);                                                         \
+    }                                                                                                                  \
+    size_t childCount = tree->levelOffsets[level] - tree->levelOffsets[level - 1];                                     \
+    size_t begin = node * FIND_MIN_TREE_FANOUT;                                                                        \
+    size_t size = childCount - begin < FIND_MIN_TREE_FANOUT ? childCount - begin : FIND_MIN_TREE_FANOUT;               \
+    return kernel##suffix(tree->nodes + tree->levelOffsets[level - 1] + begin, size, lowest);                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void * computeTreeLevel##suffix(void * slice)                                                                 \
+  {                                                                                                                    \
+    TreeLevelSlice##suffix * s = (TreeLevelSlice##suffix *) slice;                                                     \
+    FindMinTree##suffix * tree = s->tree;                                                                              \
+    type * row = tree->nodes + tree->levelOffsets[s->level];                                                           \
+    unsigned char * dirty = tree->dirty + tree->levelOffsets[s->level];                                                \
+    unsigned char * parentDirty = tree->dirty + tree->levelOffsets[s->level + 1];                                      \
+    int hasParent = s->level + 1 < tree->levelCount;                                                                   \
+    size_t i;                                                                                                          \
+    for (i = s->begin; i < s->end; ++i)                                                                                \
+    {                                                                                                                  \
+      if (s->onlyDirty)                                                                                                \
+      {                                                                                                                \
+        if (!dirty[i]) continue;                                                                                       \
+        dirty[i] = 0;                                                                                                  \
+      }                                                                                                                \
+      type value = computeTreeNode##suffix(tree, s->level, i);                                                         \
+      if (s->onlyDirty && hasParent && !(value == row[i]))                                                             \
+      {                                                                                                                \
+        parentDirty[i / FIND_MIN_TREE_FANOUT] = 1;                                                                     \
+      }                                                                                                                \
+      row[i] = value;                                                                                                  \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+  }                                                                                                                    \
+                                                                                                                       \
+  static void computeTreeLevels##suffix(FindMinTree##suffix * tree, int onlyDirty, FindMinOptions const * options)     \
+  {                                                                                                                    \
+    size_t level;                                                                                                      \
+    for (level = 0; level < tree->levelCount; ++level)                                                                 \
+    {                                                                                                                  \
+      size_t nodeCount = tree->levelOffsets[level + 1] - tree->levelOffsets[level];                                    \
+      /* Slices start on a multiple of the fanout, so no two threads mark the same parent dirty */                     \
+      size_t groupCount = (nodeCount + FIND_MIN_TREE_FANOUT - 1) / FIND_MIN_TREE_FANOUT;                               \
+      size_t threadCount = resolveThreadCount(options, nodeCount, FIND_MIN_DEFAULT_CHUNK_SIZE);                        \
+      TreeLevelSlice##suffix onlySlice;                                                                                \
+      TreeLevelSlice##suffix * slices = &onlySlice;                                                                    \
+      if (threadCount > 1)                                                                                             \
+      {                                                                                                                \
+        slices = (TreeLevelSlice##suffix *) malloc(threadCount * sizeof(TreeLevelSlice##suffix));                      \
+        if (!slices)                                                                                                   \
+        {                                                                                                              \
+          slices = &onlySlice;                                                                                         \
+          threadCount = 1;                                                                                             \
+        }                                                                                                              \
+      }                                                                                                                \
+      size_t i;                                                                                                        \
+      for (i = 0; i < threadCount; ++i)                                                                                \
+      {                                                                                                                \
+        size_t begin = groupCount * i / threadCount * FIND_MIN_TREE_FANOUT;                                            \
+        size_t end = groupCount * (i + 1) / threadCount * FIND_MIN_TREE_FANOUT;                                        \
+        slices[i].tree = tree;                                                                                         \
+        slices[i].level = level;                                                                                       \
+        slices[i].begin = begin;                                                                                       \
+        slices[i].end = end < nodeCount ? end : nodeCount;                                                             \
+        slices[i].onlyDirty = onlyDirty;                                                                               \
+      }                                                                                                                \
+      runSlices(slices, sizeof(*slices), threadCount, computeTreeLevel##suffix);                                       \
+      if (slices != &onlySlice)                                                                                        \
+      {                                                                                                                \
+        free(slices);                                                                                                  \
+      }                                                                                                                \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  int findMinBuildTree##suffix(FindMinTree##suffix * tree, type * data, size_t size, FindMinOptions const * options)   \
+  {                                                                                                                    \
+    tree->data = data;                                                                                                 \
+    tree->size = size;                                                                                                 \
+    tree->levelCount = 0;                                                                                              \
+    tree->levelOffsets[0] = 0;                                                                                         \
+    tree->nodes = NULL;                                                                                                \
+    tree->dirty = NULL;                                                                                                \
+    size_t nodeCount = (size + FIND_MIN_TREE_LEAF_SIZE - 1) / FIND_MIN_TREE_LEAF_SIZE;                                 \
+    while (nodeCount > 0)                                                                                              \
+    {                                                                                                                  \
+      tree->levelOffsets[tree->levelCount + 1] = tree->levelOffsets[tree->levelCount] + nodeCount;                     \
+      ++tree->levelCount;                                                                                              \
+      nodeCount = nodeCount > 1 ? (nodeCount + FIND_MIN_TREE_FANOUT - 1) / FIND_MIN_TREE_FANOUT : 0;                   \
+    }                                                                                                                  \
+    if (tree->levelCount == 0) return 0;                                                                               \
+    size_t totalNodeCount = tree->levelOffsets[tree->levelCount];                                                      \
+    tree->nodes = (type *) malloc(totalNodeCount * sizeof(type));                                                      \
+    tree->dirty = (unsigned char *) calloc(totalNodeCount, 1);                                                         \
+    if (!tree->nodes || !tree->dirty)                                                                                  \
+    {                                                                                                                  \
+      findMinFreeTree##suffix(tree);                                                                                   \
+      return -1;                                                                                                       \
+    }                                                                                                                  \
+    computeTreeLevels##suffix(tree, 0, options);                                                                       \
+    return 0;                                                                                                          \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinFreeTree##suffix(FindMinTree##suffix * tree)                                                             \
+  {                                                                                                                    \
+    free(tree->nodes);                                                                                                 \
+    free(tree->dirty);                                                                                                 \
+    tree->nodes = NULL;                                                                                                \
+    tree->dirty = NULL;                                                                                                \
+    tree->levelCount = 0;                                                                                              \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinTreeMin##suffix(FindMinTree##suffix const * tree)                                                        \
+  {                                                                                                                    \
+    return tree->levelCount > 0 ? tree->nodes[tree->levelOffsets[tree->levelCount - 1]] : highest;                     \
+  }                                                                                                                    \
+                                                                                                                       \
+  type findMinTreeRange##suffix(FindMinTree##suffix const * tree, size_t begin, size_t end)                            \
+  {                                                                                                                    \
+    end = end < tree->size ? end : tree->size;                                                                         \
+    if (begin >= end) return highest;                                                                                  \
+    size_t first = (begin + FIND_MIN_TREE_LEAF_SIZE - 1) / FIND_MIN_TREE_LEAF_SIZE;                                    \
+    size_t last = end / FIND_MIN_TREE_LEAF_SIZE;                                                                       \
+    if (first >= last) return kernel##suffix(tree->data + begin, end - begin, lowest);                                 \
+    type min = kernel##suffix(tree->data + begin, first * FIND_MIN_TREE_LEAF_SIZE - begin, lowest);                    \
+    type edge = kernel##suffix(tree->data + last * FIND_MIN_TREE_LEAF_SIZE, end - last * FIND_MIN_TREE_LEAF_SIZE,      \
+                               lowest);                                                                                \
+    min = edge < min ? edge : min;                                                                                     \
+    /* Climb while the nodes [first, last) cover whole parents, scanning the nodes at the edges that do not */         \
+    size_t level;                                                                                                      \
+    for (level = 0; first < last; ++level)                                                                             \
+    {                                                                                                                  \
+      type const * row = tree->nodes + tree->levelOffsets[level];                                                      \
+      size_t parentFirst = (first + FIND_MIN_TREE_FANOUT - 1) / FIND_MIN_TREE_FANOUT;                                  \
+      size_t parentLast = last / FIND_MIN_TREE_FANOUT;                                                                 \
+      if (parentFirst >= parentLast)                                                                                   \
+      {                                                                                                                \
+        edge = kernel##suffix(row + first, last - first, lowest);                                                      \
+        return edge < min ? edge : min;                                                                                \
+      }                                                                                                                \
+      edge = kernel##suffix(row + first, parentFirst * FIND_MIN_TREE_FANOUT - first, lowest);                          \
+      min = edge < min ? edge : min;                                                                                   \
+      edge = kernel##suffix(row + parentLast * FIND_MIN_TREE_FANOUT, last - parentLast * FIND_MIN_TREE_FANOUT, lowest);\
+      min = edge < min ? edge : min;                                                                                   \
+      first = parentFirst;                                                                                             \
+      last = parentLast;                                                                                               \
+    }                                                                                                                  \
+    return min;                                                                                                        \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinTreeUpdate##suffix(FindMinTree##suffix * tree, size_t index, type value)                                 \
+  {                                                                                                                    \
+    tree->data[index] = value;                                                                                         \
+    size_t node = index / FIND_MIN_TREE_LEAF_SIZE;                                                                     \
+    size_t level;                                                                                                      \
+    for (level = 0; level < tree->levelCount; ++level)                                                                 \
+    {                                                                                                                  \
+      type * slot = tree->nodes + tree->levelOffsets[level] + node;                                                    \
+      type nodeMin = computeTreeNode##suffix(tree, level, node);                                                       \
+      /* The ancestors only change if this node did */                                                                 \
+      if (nodeMin == *slot) return;                                                                                    \
+      *slot = nodeMin;                                                                                                 \
+      node /= FIND_MIN_TREE_FANOUT;                                                                                    \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  void findMinTreeUpdates##suffix(FindMinTree##suffix * tree, size_t const * indices, type const * values,             \
+                                  size_t count, FindMinOptions const * options)                                        \
+  {                                                                                                                    \
+    size_t leafCount = tree->levelCount > 0 ? tree->levelOffsets[1] : 0;                                               \
+    size_t i;                                                                                                          \
+    /* Sweeping the tree reads a dirty flag per node, which does not pay for itself on batches that touch few leaves */\
+    if (count < leafCount / FIND_MIN_TREE_LEAF_SIZE)                                                                   \
+    {                                                                                                                  \
+      for (i = 0; i < count; ++i)                                                                                      \
+      {                                                                                                                \
+        findMinTreeUpdate##suffix(tree, indices[i], values[i]);                                                        \
+      }                                                                                                                \
+      return;                                                                                                          \
+    }                                                                                                                  \
+    for (i = 0; i < count; ++i)                                                                                        \
+    {                                                                                                                  \
+      tree->data[indices[i]] = values[i];                                                                              \
+      tree->dirty[indices[i] / FIND_MIN_TREE_LEAF_SIZE] = 1;                                                           \
+    }                                                                                                                  \
+    computeTreeLevels##suffix(tree, 1, options);                                                                       \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE_TREE)
+
+/**
+ * Defines `findFirstBelow<Type>()` for one element type, along with `FirstBelowSlice<Type>` and
+ * `searchFirstBelow<Type>()`, run by each thread. The threads claim chunks in ascending order from the shared
+ * `nextChunk`, and lower the shared `first` to the index of each match they find, so a match only cancels the chunks
+ * above it: a thread working on a lower chunk carries on until it finds an earlier match or reaches the end of its
+ * chunk. Blocks of `FIND_MIN_SELECT_BLOCK_SIZE` elements are skipped by their minimum, and only searched element by
+ * element once it is below the threshold.
+ */
+#define FIND_MIN_DEFINE_FIRST_BELOW(suffix, type, lowest, highest, sumType)                                            \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    type const * data;                                                                                                 \
+    size_t size;                                                                                                       \
+    type threshold;                                                                                                    \
+    size_t chunkSize;                                                                                                  \
+    size_t * nextChunk;                                                                                                \
+    size_t * first;                                                                                                    \
+  } FirstBelowSlice##suffix;                                                                                           \
+                                                                                                                       \
+  static void * searchFirstBelow##suffix(void * slice)                                                                 \
+  {                                                                                                                    \
+    FirstBelowSlice##suffix * s = (FirstBelowSlice##suffix *) slice;                                                   \
+    for (;;)                                                                                                           \
+    {                                                                                                                  \
+      size_t begin = __atomic_fetch_add(s->nextChunk, s->chunkSize, __ATOMIC_RELAXED);                                 \
+      /* Chunks are claimed in ascending order, so once one starts past a match, so do all the rest */                 \
+      if (begin >= s->size || begin >= __atomic_load_n(s->first, __ATOMIC_RELAXED)) return NULL;                       \
+      size_t end = s->size - begin < s->chunkSize ? s->size : begin + s->chunkSize;                                    \
+      size_t i;                                                                                                        \
+      for (i = begin; i < end; i += FIND_MIN_SELECT_BLOCK_SIZE)                                                        \
+      {                                                                                                                \
+        if (i > begin && i >= __atomic_load_n(s->first, __ATOMIC_RELAXED)) return NULL;                                \
+        size_t blockEnd = end - i < FIND_MIN_SELECT_BLOCK_SIZE ? end : i + FIND_MIN_SELECT_BLOCK_SIZE;                 \
+        if (!(kernel##suffix(s->data + i, blockEnd - i, lowest) < s->threshold)) continue;                             \
+        while (!(s->data[i] < s->threshold))                                                                           \
+        {                                                                                                              \
+          ++i;                                                                                                         \
+        }                                                                                                              \
+        size_t first = __atomic_load_n(s->first, __ATOMIC_RELAXED);                                                    \
+        while (i < first && !__atomic_compare_exchange_n(s->first, &first, i, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))  \
+        {                                                                                                              \
+        }                                                                                                              \
+        return NULL;                                                                                                   \
+      }                                                                                                                \
+    }                                                                                                                  \
+  }                                                                                                                    \
+                                                                                                                       \
+  size_t findFirstBelow##suffix(type const * data, size_t size, type threshold, FindMinOptions const * options)        \
+  {                                                                                                                    \
+    size_t chunkSize = options && options->chunkSize ? options->chunkSize : FIND_MIN_DEFAULT_CHUNK_SIZE;               \
+    size_t threadCount = resolveThreadCount(options, size, chunkSize);                                                 \
+    size_t nextChunk = 0;                                                                                              \
+    size_t first = SIZE_MAX;                                                                                           \
+    FirstBelowSlice##suffix onlySlice;                                                                                 \
+    FirstBelowSlice##suffix * slices = &onlySlice;                                                                     \
+    if (threadCount > 1)                                                                                               \
+    {                                                                                                                  \
+      slices = (FirstBelowSlice##suffix *) malloc(threadCount * sizeof(FirstBelowSlice##suffix));                      \
+      if (!slices)                                                                                                     \
+      {                                                                                                                \
+        slices = &onlySlice;                                                                                           \
+        threadCount = 1;                                                                                               \
+      }                                                                                                                \
+    }                                                                                                                  \
+    size_t i;                                                                                                          \
+    for (i = 0; i < threadCount; ++i)                                                                                  \
+    {                                                                                                                  \
+      slices[i].data = data;                                                                                           \
+      slices[i].size = size;                                                                                           \
+      slices[i].threshold = threshold;                                                                                 \
+      slices[i].chunkSize = chunkSize;                                                                                 \
+      slices[i].nextChunk = &nextChunk;                                                                                \
+      slices[i].first = &first;                                                                                        \
+    }                                                                                                                  \
+    runSlices(slices, sizeof(*slices), threadCount, searchFirstBelow##suffix);                                         \
+    if (slices != &onlySlice)                                                                                          \
+    {                                                                                                                  \
+      free(slices);                                                                                                    \
+    }                                                                                                                  \
+    return first;                                                                                                      \
+  }
+
+FIND_MIN_TYPES(FIND_MIN_DEFINE_FIRST_BELOW)
+
+#ifdef HAVE_X86_KERNELS
+/**
+ * AVX2 `int32_t` kernel. Scans blocks of four 8-lane vectors, checking against the sentinel once per block.
+ */
+__attribute__((target("avx2")))
+static int32_t findMinKernelAvx2(int32_t const * data, size_t size, int32_t sentinel)
+{
+  __m256i const bound = _mm256_set1_epi32(sentinel);
+  __m256i min = _mm256_set1_epi32(INT32_MAX);
+  size_t i;
+  for (i = 0; i + 32 <= size; i += 32)
+  {
+    __m256i a = _mm256_min_epi32(_mm256_loadu_si256((__m256i const *) (data + i)),
+                                 _mm256_loadu_si256((__m256i const *) (data + i + 8)));
+    __m256i b = _mm256_min_epi32(_mm256_loadu_si256((__m256i const *) (data + i + 16)),
+                                 _mm256_loadu_si256((__m256i const *) (data + i + 24)));
+    min = _mm256_min_epi32(min, _mm256_min_epi32(a, b));
+    if (_mm256_movemask_epi8(_mm256_cmpgt_epi32(min, bound)) != -1) break;
+  }
+  __m128i half = _mm_min_epi32(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1));
+  half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+  half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+  int32_t result = _mm_cvtsi128_si32(half);
+  // Until a block is scanned, `min` only holds its starting value, which is not an element
+  if (i > 0 && result <= sentinel) return result;
+  for (; i < size; ++i)
+  {
+    if (data[i] < result)
+    {
+      result = data[i];
+    }
+  }
+  return result;
+}
+
+/**
+ * AVX-512 `int32_t` kernel. Scans blocks of four 16-lane vectors, checking against the sentinel once per block.
+ */
+__attribute__((target("avx512f")))
+static int32_t findMinKernelAvx512(int32_t const * data, size_t size, int32_t sentinel)
+{
+  __m512i const bound = _mm512_set1_epi32(sentinel);
+  __m512i min = _mm512_set1_epi32(INT32_MAX);
+  size_t i;
+  for (i = 0; i + 64 <= size; i += 64)
+  {
+    __m512i a = _mm512_min_epi32(_mm512_loadu_si512(data + i), _mm512_loadu_si512(data + i + 16));
+    __m512i b = _mm512_min_epi32(_mm512_loadu_si512(data + i + 32), _mm512_loadu_si512(data + i + 48));
+    min = _mm512_min_epi32(min, _mm512_min_epi32(a, b));
+    if (_mm512_cmple_epi32_mask(min, bound)) break;
+  }
+  int32_t result = _mm512_reduce_min_epi32(min);
+  if (i > 0 && result <= sentinel) return result;
+  for (; i < size; ++i)
+  {
+    if (data[i] < result)
+    {
+      result = data[i];
+    }
+  }
+  return result;
+}
+
+/**
+ * SSE4.1 `int32_t` kernel. Scans blocks of four 4-lane vectors, checking against the sentinel once per block.
+ */
+__attribute__((target("sse4.1")))
+static int32_t findMinKernelSse41(int32_t const * data, size_t size, int32_t sentinel)
+{
+  __m128i const bound = _mm_set1_epi32(sentinel);
+  __m128i min = _mm_set1_epi32(INT32_MAX);
+  size_t i;
+  for (i = 0; i + 16 <= size; i += 16)
+  {
+    __m128i a = _mm_min_epi32(_mm_loadu_si128((__m128i const *) (data + i)),
+                              _mm_loadu_si128((__m128i const *) (data + i + 4)));
+    __m128i b = _mm_min_epi32(_mm_loadu_si128((__m128i const *) (data + i + 8)),
+                              _mm_loadu_si128((__m128i const *) (data + i + 12)));
+    min = _mm_min_epi32(min, _mm_min_epi32(a, b));
+    if (_mm_movemask_epi8(_mm_cmpgt_epi32(min, bound)) != 0xFFFF) break;
+  }
+  min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+  min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+  int32_t result = _mm_cvtsi128_si32(min);
+  if (i > 0 && result <= sentinel) return result;
+  for (; i < size; ++i)
+  {
+    if (data[i] < result)
+    {
+      result = data[i];
+    }
+  }
+  return result;
+}
+
+/**
+ * Defines the SIMD kernels of an unsigned narrow type of `bits` bits (8 or 16), which fit two or four times as many
+ * lanes in a vector as the `int32_t` kernels, and work like them: `findMinKernelAvx2<Type>()`,
+ * `findMinKernelAvx512<Type>()` (which needs AVX-512BW for byte and word lanes) and `findMinKernelSse41<Type>()`.
+ * `reduceMin<Type>()` returns the minimum of the lanes of a vector, with SSE4.1's horizontal `phminposuw`.
+ */
+#define FIND_MIN_DEFINE_NARROW_KERNELS(suffix, type, bits)                                                             \
+  __attribute__((target("sse4.1")))                                                                                    \
+  static type reduceMin##suffix(__m128i min)                                                                           \
+  {                                                                                                                    \
+    if (bits == 8)                                                                                                     \
+    {                                                                                                                  \
+      /* Fold the odd bytes onto the even ones, leaving the minima zero-extended to 16 bits */                         \
+      min = _mm_and_si128(_mm_min_epu8(min, _mm_srli_epi16(min, 8)), _mm_set1_epi16(0xFF));                            \
+    }                                                                                                                  \
+    return (type) _mm_cvtsi128_si32(_mm_minpos_epu16(min));                                                            \
+  }                                                                                                                    \
+                                                                                                                       \
+  __attribute__((target("avx2")))                                                                                      \
+  static type findMinKernelAvx2##suffix(type const * data, size_t size, type sentinel)                                 \
+  {                                                                                                                    \
+    size_t const lanes = sizeof(__m256i) / sizeof(type);                                                               \
+    __m256i const bound = _mm256_set1_epi##bits(sentinel);                                                             \
+    __m256i min = _mm256_set1_epi##bits(-1);                                                                           \
+    size_t i;                                                                                                          \
+    for (i = 0; i + 4 * lanes <= size; i += 4 * lanes)                                                                 \
+    {                                                                                                                  \
+      __m256i a = _mm256_min_epu##bits(_mm256_loadu_si256((__m256i const *) (data + i)),                               \
+                                       _mm256_loadu_si256((__m256i const *) (data + i + lanes)));                      \
+      __m256i b = _mm256_min_epu##bits(_mm256_loadu_si256((__m256i const *) (data + i + 2 * lanes)),                   \
+                                       _mm256_loadu_si256((__m256i const *) (data + i + 3 * lanes)));                  \
+      min = _mm256_min_epu##bits(min, _mm256_min_epu##bits(a, b));                                                     \
+      if (_mm256_movemask_epi8(_mm256_cmpeq_epi##bits(_mm256_min_epu##bits(min, bound), min))) break;                  \
+    }                                                                                                                  \
+    type result = reduceMin##suffix(_mm_min_epu##bits(_mm256_castsi256_si128(min), _mm256_extracti128_si256(min, 1))); \
+    if (i > 0 && result <= sentinel) return result;                                                                    \
+    for (; i < size; ++i)                                                                                              \
+    {                                                                                                                  \
+      if (data[i] < result)                                                                                            \
+      {                                                                                                                \
+        result = data[i];                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return result;                                                                                                     \
+  }                                                                                                                    \
+                                                                                                                       \
+  __attribute__((target("avx512bw")))                                                                                  \
+  static type findMinKernelAvx512##suffix(type const * data, size_t size, type sentinel)                               \
+  {                                                                                                                    \
+    size_t const lanes = sizeof(__m512i) / sizeof(type);                                                               \
+    __m512i const bound = _mm512_set1_epi##bits(sentinel);                                                             \
+    __m512i min = _mm512_set1_epi##bits(-1);                                                                           \
+    size_t i;                                                                                                          \
+    for (i = 0; i + 4 * lanes <= size; i += 4 * lanes)                                                                 \
+    {                                                                                                                  \
+      __m512i a = _mm512_min_epu##bits(_mm512_loadu_si512(data + i), _mm512_loadu_si512(data + i + lanes));            \
+      __m512i b = _mm512_min_epu##bits(_mm512_loadu_si512(data + i + 2 * lanes),                                       \
+                                       _mm512_loadu_si512(data + i + 3 * lanes));                                      \
+      min = _mm512_min_epu##bits(min, _mm512_min_epu##bits(a, b));                                                     \
+      if (_mm512_cmple_epu##bits##_mask(min, bound)) break;                                                            \
+    }                                                                                                                  \
+    __m256i half = _mm256_min_epu##bits(_mm512_castsi512_si256(min), _mm512_extracti64x4_epi64(min, 1));               \
+    __m128i quarter = _mm_min_epu##bits(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1));              \
+    type result = reduceMin##suffix(quarter);                                                                          \
+    if (i > 0 && result <= sentinel) return result;                                                                    \
+    for (; i < size; ++i)                                                                                              \
+    {                                                                                                                  \
+      if (data[i] < result)                                                                                            \
+      {                                                                                                                \
+        result = data[i];                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return result;                                                                                                     \
+  }                                                                                                                    \
+                                                                                                                       \
+  __attribute__((target("sse4.1")))                                                                                    \
+  static type findMinKernelSse41##suffix(type const * data, size_t size, type sentinel)                                \
+  {                                                                                                                    \
+    size_t const lanes = sizeof(__m128i) / sizeof(type);                                                               \
+    __m128i const bound = _mm_set1_epi##bits(sentinel);                                                                \
+    __m128i min = _mm_set1_epi##bits(-1);                                                                              \
+    size_t i;                                                                                                          \
+    for (i = 0; i + 4 * lanes <= size; i += 4 * lanes)                                                                 \
+    {                                                                                                                  \
+      __m128i a = _mm_min_epu##bits(_mm_loadu_si128((__m128i const *) (data + i)),                                     \
+                                    _mm_loadu_si128((__m128i const *) (data + i + lanes)));                            \
+      __m128i b = _mm_min_epu##bits(_mm_loadu_si128((__m128i const *) (data + i + 2 * lanes)),                         \
+                                    _mm_loadu_si128((__m128i const *) (data + i + 3 * lanes)));                        \
+      min = _mm_min_epu##bits(min, _mm_min_epu##bits(a, b));                                                           \
+      if (_mm_movemask_epi8(_mm_cmpeq_epi##bits(_mm_min_epu##bits(min, bound), min))) break;                           \
+    }                                                                                                                  \
+    type result = reduceMin##suffix(min);                                                                              \
+    if (i > 0 && result <= sentinel) return result;                                                                    \
+    for (; i < size; ++i)                                                                                              \
+    {                                                                                                                  \
+      if (data[i] < result)                                                                                            \
+      {                                                                                                                \
+        result = data[i];                                                                                              \
+      }                                                                                                                \
+    }                                                                                                                  \
+    return result;                                                                                                     \
+  }
+
+FIND_MIN_DEFINE_NARROW_KERNELS(Uint8, uint8_t, 8)
+FIND_MIN_DEFINE_NARROW_KERNELS(Uint16, uint16_t, 16)
+
+/**
+ * AVX2 counterpart of `reduceBlockInt32With<statistics>()`, inlined into one function per combination of statistics
+ * by `FIND_MIN_DEFINE_REDUCE_KERNEL`. Scans 8-lane vectors. The sum is kept in 32-bit lanes as the sums of the high
+ * (signed) and low 16 bits of the elements, which cannot overflow within `FIND_MIN_REDUCE_BLOCK_SIZE` elements, and
+ * widened once per block; the count below `threshold` is kept in 32-bit lanes, subtracting each comparison's -1.
+ */
+__attribute__((target("avx2"), always_inline))
+static __inline__ void reduceBlockAvx2(int32_t const * block, size_t size, int32_t threshold, ReduceSliceInt32 * s,
+                                       unsigned statistics)
+{
+  __m256i const bound = _mm256_set1_epi32(threshold);
+  __m256i const lowBits = _mm256_set1_epi32(0xFFFF);
+  __m256i min = _mm256_set1_epi32(s->minimum);
+  __m256i max = _mm256_set1_epi32(s->maximum);
+  __m256i sumHigh = _mm256_setzero_si256();
+  __m256i sumLow = _mm256_setzero_si256();
+  __m256i countBelow = _mm256_setzero_si256();
+  size_t i;
+  for (i = 0; i + 8 <= size; i += 8)
+  {
+    __m256i v = _mm256_loadu_si256((__m256i const *) (block + i));
+    if (statistics & FIND_MIN_MINIMUM) min = _mm256_min_epi32(min, v);
+    if (statistics & FIND_MIN_MAXIMUM) max = _mm256_max_epi32(max, v);
+    if (statistics & FIND_MIN_SUM)
+    {
+      sumHigh = _mm256_add_epi32(sumHigh, _mm256_srai_epi32(v, 16));
+      sumLow = _mm256_add_epi32(sumLow, _mm256_and_si256(v, lowBits));
+    }
+    if (statistics & FIND_MIN_COUNT_BELOW) countBelow = _mm256_sub_epi32(countBelow, _mm256_cmpgt_epi32(bound, v));
+  }
+  int32_t lanes[5][8];
+  _mm256_storeu_si256((__m256i *) lanes[0], min);
+  _mm256_storeu_si256((__m256i *) lanes[1], max);
+  _mm256_storeu_si256((__m256i *) lanes[2], sumHigh);
+  _mm256_storeu_si256((__m256i *) lanes[3], sumLow);
+  _mm256_storeu_si256((__m256i *) lanes[4], countBelow);
+  int32_t blockMin = s->minimum;
+  int32_t blockMax = s->maximum;
+  int64_t sum = 0;
+  size_t lane;
+  for (lane = 0; lane < 8; ++lane)
+  {
+    blockMin = lanes[0][lane] < blockMin ? lanes[0][lane] : blockMin;
+    blockMax = lanes[1][lane] > blockMax ? lanes[1][lane] : blockMax;
+    sum += (int64_t) lanes[2][lane] * 65536 + lanes[3][lane];
+    s->countBelow += (uint32_t) lanes[4][lane];
+  }
+  for (; i < size; ++i)
+  {
+    blockMin = block[i] < blockMin ? block[i] : blockMin;
+    blockMax = block[i] > blockMax ? block[i] : blockMax;
+    sum += block[i];
+    s->countBelow += block[i] < threshold;
+  }
+  if (statistics & FIND_MIN_MINIMUM) s->minimum = blockMin;
+  if (statistics & FIND_MIN_MAXIMUM) s->maximum = blockMax;
+  if (statistics & FIND_MIN_SUM) s->sum += sum;
+}
+
+/**
+ * AVX-512 counterpart of `reduceBlockInt32With<statistics>()`, like `reduceBlockAvx2()` but with 16-lane vectors, and
+ * the count below `threshold` added under the comparison's mask.
+ */
+__attribute__((target("avx512f"), always_inline))
+static __inline__ void reduceBlockAvx512(int32_t const * block, size_t size, int32_t threshold, ReduceSliceInt32 * s,
+                                         unsigned statistics)
+{
+  __m512i const bound = _mm512_set1_epi32(threshold);
+  __m512i const lowBits = _mm512_set1_epi32(0xFFFF);
+  __m512i const one = _mm512_set1_epi32(1);
+  __m512i min = _mm512_set1_epi32(s->minimum);
+  __m512i max = _mm512_set1_epi32(s->maximum);
+  __m512i sumHigh = _mm512_setzero_si512();
+  __m512i sumLow = _mm512_setzero_si512();
+  __m512i countBelow = _mm512_setzero_si512();
+  size_t i;
+  for (i = 0; i + 16 <= size; i += 16)
+  {
+    __m512i v = _mm512_loadu_si512(block + i);
+    if (statistics & FIND_MIN_MINIMUM) min = _mm512_min_epi32(min, v);
+    if (statistics & FIND_MIN_MAXIMUM) max = _mm512_max_epi32(max, v);
+    if (statistics & FIND_MIN_SUM)
+    {
+      sumHigh = _mm512_add_epi32(sumHigh, _mm512_srai_epi32(v, 16));
+      sumLow = _mm512_add_epi32(sumLow, _mm512_and_si512(v, lowBits));
+    }
+    if (statistics & FIND_MIN_COUNT_BELOW)
+    {
+      countBelow = _mm512_mask_add_epi32(countBelow, _mm512_cmplt_epi32_mask(v, bound), countBelow, one);
+    }
+  }
+  int32_t blockMin = _mm512_reduce_min_epi32(min);
+  int32_t blockMax = _mm512_reduce_max_epi32(max);
+  int64_t sum = (int64_t) _mm512_reduce_add_epi32(sumHigh) * 65536 + _mm512_reduce_add_epi32(sumLow);
+  s->countBelow += (uint32_t) _mm512_reduce_add_epi32(countBelow);
+  for (; i < size; ++i)
+  {
+    blockMin = block[i] < blockMin ? block[i] : blockMin;
+    blockMax = block[i] > blockMax ? block[i] : blockMax;
+    sum += block[i];
+    s->countBelow += block[i] < threshold;
+  }
+  if (statistics & FIND_MIN_MINIMUM) s->minimum = blockMin;
+  if (statistics & FIND_MIN_MAXIMUM) s->maximum = blockMax;
+  if (statistics & FIND_MIN_SUM) s->sum += sum;
+}
+
+/**
+ * Defines `reduceBlock<isa>With<statistics>()`, `reduceBlock<isa>()` specialized for `statistics`.
+ */
+#define FIND_MIN_DEFINE_REDUCE_KERNEL(isa, targetName, type, sumType, statistics)                                      \
+  __attribute__((target(targetName)))                                                                                  \
+  static void reduceBlock##isa##With##statistics(type const * block, size_t size, type threshold,                      \
+                                                 ReduceSliceInt32 * s)                                                 \
+  {                                                                                                                    \
+    reduceBlock##isa(block, size, threshold, s, statistics);                                                           \
+  }
+
+FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_DEFINE_REDUCE_KERNEL, Avx2, "avx2", int32_t, int64_t)
+FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_DEFINE_REDUCE_KERNEL, Avx512, "avx512f", int32_t, int64_t)
+
+static void (* const reduceBlocksAvx2[FIND_MIN_REDUCE_SCALARS + 1])(int32_t const *, size_t, int32_t,
+                                                                   ReduceSliceInt32 *) = {
+  NULL, FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_REDUCE_BLOCK_NAME, Avx2, "avx2", int32_t, int64_t)
+};
+static void (* const reduceBlocksAvx512[FIND_MIN_REDUCE_SCALARS + 1])(int32_t const *, size_t, int32_t,
+                                                                     ReduceSliceInt32 *) = {
+  NULL, FIND_MIN_REDUCE_COMBINATIONS(FIND_MIN_REDUCE_BLOCK_NAME, Avx512, "avx512f", int32_t, int64_t)
+};
+
+/**
+ * AVX2 counterpart of `computeBinsInt32()`. Scans 8-lane vectors: `_mm256_mul_epu32()` multiplies the even lanes and
+ * the odd lanes (shifted down) into 64-bit products, whose bins are blended back into 32-bit lanes.
+ */
+__attribute__((target("avx2")))
+static void computeBinsAvx2(int32_t const * block, size_t size, ReduceSliceInt32 const * s, uint32_t * binIndices)
+{
+  if (!s->binExact)
+  {
+    computeBinsInt32(block, size, s, binIndices);
+    return;
+  }
+  __m256i const low = _mm256_set1_epi32(s->reduction->histogramLow);
+  __m256i const span = _mm256_set1_epi32((int32_t) (uint32_t) s->binSpan);
+  __m256i const multiplier = _mm256_set1_epi32((int32_t) s->binMultiplier);
+  __m256i const outOfRange = _mm256_set1_epi32((int32_t) s->binCount);
+  __m128i const precision = _mm_cvtsi32_si128((int) s->binPrecision);
+  size_t i;
+  for (i = 0; i + 8 <= size; i += 8)
+  {
+    __m256i offset = _mm256_sub_epi32(_mm256_loadu_si256((__m256i const *) (block + i)), low);
+    __m256i even = _mm256_srl_epi64(_mm256_mul_epu32(offset, multiplier), precision);
+    __m256i odd = _mm256_srl_epi64(_mm256_mul_epu32(_mm256_srli_epi64(offset, 32), multiplier), precision);
+    __m256i bins = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+    // offset <= span, unsigned
+    __m256i inRange = _mm256_cmpeq_epi32(_mm256_min_epu32(offset, span), offset);
+    _mm256_storeu_si256((__m256i *) (binIndices + i), _mm256_blendv_epi8(outOfRange, bins, inRange));
+  }
+  for (; i < size; ++i)
+  {
+    uint32_t offset = (uint32_t) block[i] - (uint32_t) s->reduction->histogramLow;
+    uint32_t bin = (uint32_t) ((uint64_t) offset * s->binMultiplier >> s->binPrecision);
+    binIndices[i] = offset <= s->binSpan ? bin : (uint32_t) s->binCount;
+  }
+}
+
+/**
+ * AVX-512 counterpart of `computeBinsInt32()`, like `computeBinsAvx2()` but with 16-lane vectors, and masks in place of
+ * blends.
+ */
+__attribute__((target("avx512f")))
+static void computeBinsAvx512(int32_t const * block, size_t size, ReduceSliceInt32 const * s, uint32_t * binIndices)
+{
+  if (!s->binExact)
+  {
+    computeBinsInt32(block, size, s, binIndices);
+    return;
+  }
+  __m512i const low = _mm512_set1_epi32(s->reduction->histogramLow);
+  __m512i const span = _mm512_set1_epi32((int32_t) (uint32_t) s->binSpan);
+  __m512i const multiplier = _mm512_set1_epi32((int32_t) s->binMultiplier);
+  __m512i const outOfRange = _mm512_set1_epi32((int32_t) s->binCount);
+  __m128i const precision = _mm_cvtsi32_si128((int) s->binPrecision);
+  size_t i;
+  for (i = 0; i + 16 <= size; i += 16)
+  {
+    __m512i offset = _mm512_sub_epi32(_mm512_loadu_si512(block + i), low);
+    __m512i even = _mm512_srl_epi64(_mm512_mul_epu32(offset, multiplier), precision);
+    __m512i odd = _mm512_srl_epi64(_mm512_mul_epu32(_mm512_srli_epi64(offset, 32), multiplier), precision);
+    __m512i bins = _mm512_mask_mov_epi32(even, 0xAAAA, _mm512_slli_epi64(odd, 32));
+    __mmask16 inRange = _mm512_cmple_epu32_mask(offset, span);
+    _mm512_storeu_si512(binIndices + i, _mm512_mask_mov_epi32(outOfRange, inRange, bins));
+  }
+  for (; i < size; ++i)
+  {
+    uint32_t offset = (uint32_t) block[i] - (uint32_t) s->reduction->histogramLow;
+    uint32_t bin = (uint32_t) ((uint64_t) offset * s->binMultiplier >> s->binPrecision);
+    binIndices[i] = offset <= s->binSpan ? bin : (uint32_t) s->binCount;
+  }
+}
+#endif
+
+/**
+ * Points the `int32_t`, `uint16_t` and `uint8_t` kernels, and the block and bin kernels of `findMinReduceInt32()`, at
+ * the widest SIMD kernels the CPU supports, as reported by cpuid. Runs when the library is loaded. The SIMD kernels
+ * serve both policies: searching for the full minimum is searching until the type's lowest value.
+ */
+__attribute__((constructor))
+static void selectKernels(void)
+{
+#ifdef HAVE_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    kernelInt32 = kernelUntilInt32 = findMinKernelAvx512;
+    kernelName = "avx512";
+    memcpy(reduceBlocksInt32, reduceBlocksAvx512, sizeof(reduceBlocksInt32));
+    binKernelInt32 = computeBinsAvx512;
+  }
+  else if (__builtin_cpu_supports("avx2"))
+  {
+    kernelInt32 = kernelUntilInt32 = findMinKernelAvx2;
+    kernelName = "avx2";
+    memcpy(reduceBlocksInt32, reduceBlocksAvx2, sizeof(reduceBlocksInt32));
+    binKernelInt32 = computeBinsAvx2;
+  }
+  else if (__builtin_cpu_supports("sse4.1"))
+  {
+    kernelInt32 = kernelUntilInt32 = findMinKernelSse41;
+    kernelName = "sse4.1";
+  }
+  if (__builtin_cpu_supports("avx512bw"))
+  {
+    kernelUint8 = kernelUntilUint8 = findMinKernelAvx512Uint8;
+    kernelUint16 = kernelUntilUint16 = findMinKernelAvx512Uint16;
+  }
+  else if (__builtin_cpu_supports("avx2"))
+  {
+    kernelUint8 = kernelUntilUint8 = findMinKernelAvx2Uint8;
+    kernelUint16 = kernelUntilUint16 = findMinKernelAvx2Uint16;
+  }
+  else if (__builtin_cpu_supports("sse4.1"))
+  {
+    kernelUint8 = kernelUntilUint8 = findMinKernelSse41Uint8;
+    kernelUint16 = kernelUntilUint16 = findMinKernelSse41Uint16;
+  }
+#endif
+}
+
+char const * findMinKernelName(void)
+{
+  return kernelName;
+}
@@ -0,0 +1,193 @@
+//===- FindMin.h --------------------------------------------------------------------------------------------------===//
+//
+// Parallel minimum search over arrays of any arithmetic type.
+//
+//===--------------------------------------------------------------------------------------------------------------===//
+// Every function is generated once per element type in `FIND_MIN_TYPES`, and named after the type's suffix - for
+// example `findMinInt32()` and `findMinUntilDouble()`. Each type has two policies, each with its own kernel:
+// - `findMin<Type>` returns the minimum of every element. Its identity (the result for an empty array) is the type's
+//   maximum.
+// - `findMinUntil<Type>` stops early once it finds an element no greater than `sentinel`. If `sentinel` is a lower
+//   bound of the data (0 for counts, for example), the result is still the exact minimum.
+// Floating point NaNs are ignored, and the identity of the floating point types is +infinity.
+//===--------------------------------------------------------------------------------------------------------------===//
+
+#ifndef FIND_MIN_H
+#define FIND_MIN_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default number of elements searched between checks of the stop flag, when `FindMinOptions::chunkSize` is 0
+#define FIND_MIN_DEFAULT_CHUNK_SIZE 16384
+// Default number of elements per block of a range index, when `findMinBuildRangeIndex<Type>()`'s `blockSize` is 0
+#define FIND_MIN_DEFAULT_RANGE_BLOCK_SIZE 256
+// Number of elements of the data each leaf of a min tree covers
+#define FIND_MIN_TREE_LEAF_SIZE 64
+// Number of children of each inner node of a min tree (a cache line of `int32_t`)
+#define FIND_MIN_TREE_FANOUT 16
+// Greatest number of levels a min tree can have: enough for `SIZE_MAX` elements
+#define FIND_MIN_TREE_MAX_LEVELS 16
+
+/**
+ * The element types the library is specialized for, as `X(suffix, type, lowest, highest, sumType)`.
+ * `lowest` and `highest` are the least and greatest values of the type, and `sumType` is the type its elements are
+ * summed in.
+ */
+#define FIND_MIN_TYPES(X)                                                                                              \
+  X(Int8, int8_t, INT8_MIN, INT8_MAX, int64_t)                                                                         \
+  X(Int16, int16_t, INT16_MIN, INT16_MAX, int64_t)                                                                     \
+  X(Int32, int32_t, INT32_MIN, INT32_MAX, int64_t)                                                                     \
+  X(Int64, int64_t, INT64_MIN, INT64_MAX, int64_t)                                                                     \
+  X(Uint8, uint8_t, 0, UINT8_MAX, uint64_t)                                                                            \
+  X(Uint16, uint16_t, 0, UINT16_MAX, uint64_t)                                                                         \
+  X(Uint32, uint32_t, 0, UINT32_MAX, uint64_t)                                                                         \
+  X(Uint64, uint64_t, 0, UINT64_MAX, uint64_t)                                                                         \
+  X(Float, float, (float) -HUGE_VAL, (float) HUGE_VAL, double)                                                         \
+  X(Double, double, -HUGE_VAL, HUGE_VAL, double)
+
+/**
+ * How a search is run. A `NULL` `FindMinOptions *` means all defaults.
+ * `threadCount` is the number of threads to search with, including the calling thread - 0 means one per online CPU.
+ * `chunkSize` is the number of elements each thread searches between checks of the stop flag - 0 means
+ * `FIND_MIN_DEFAULT_CHUNK_SIZE`.
+ */
+typedef struct
+{
+  size_t threadCount;
+  size_t chunkSize;
+} FindMinOptions;
+
+/**
+ * The statistics `findMinReduce<Type>()` can compute, to be combined with `|`.
+ */
+enum
+{
+  FIND_MIN_MINIMUM = 1 << 0,
+  FIND_MIN_MAXIMUM = 1 << 1,
+  FIND_MIN_SUM = 1 << 2,
+  FIND_MIN_COUNT_BELOW = 1 << 3,
+  FIND_MIN_HISTOGRAM = 1 << 4,
+};
+
+/**
+ * Declares the types and functions for one element type:
+ * `FindMinReduction<Type>` describes the statistics `findMinReduce<Type>()` computes, and receives them.
+ *   `statistics` is the set of `FIND_MIN_*` statistics to compute; the others are left alone.
+ *   `threshold` is the bound of `FIND_MIN_COUNT_BELOW`, which counts the elements less than it into `countBelow`.
+ *   `bins` is the caller's array of `binCount` counters that `FIND_MIN_HISTOGRAM` fills in: the range
+ *   `[histogramLow, histogramHigh)` is split into `binCount` (less than 2^31) equal bins, and elements outside of it
+ *   are not counted.
+ *   `minimum`, `maximum` and `sum` are the results of the other statistics - `highest`, `lowest` and 0 if `data` has
+ *   no elements.
+ * `findMin<Type>()` and `findMinUntil<Type>()` search `data` in parallel, as described above.
+ * `findMinKernel<Type>()` and `findMinKernelUntil<Type>()` are the single-threaded kernels they are built on, for
+ * callers that do their own threading.
+ * `findArgMin<Type>()` returns the index of the minimum - the lowest such index if it occurs more than once - or
+ * `SIZE_MAX` if `data` has no elements (or memory runs out).
+ * `findFirstBelow<Type>()` returns the lowest index of an element less than `threshold`, or `SIZE_MAX` if there is
+ * none. The threads search chunks in ascending order, and a match only cancels the chunks after it.
+ * `findSmallest<Type>()` stores the `k` smallest elements of `data` in `values` and their indices in `indices`, in
+ * ascending order of value and then index (so of equal elements, those with the lowest indices are chosen), and
+ * returns how many it stored - `k`, unless `data` has fewer elements, or 0 if memory runs out.
+ * `findMinReduce<Type>()` computes every statistic in `reduction->statistics` in a single pass over `data`.
+ * `FindMinRangeIndex<Type>` answers range minimum queries over `data` without scanning it all: `table` holds, for each
+ *   `level` below `levelCount`, the minima of every run of `2^level` of the `blockCount` whole blocks of `blockSize`
+ *   elements (a sparse table over block minima), taking `levelCount * blockCount` elements of memory. `data` must
+ *   outlive it, unchanged.
+ * `findMinBuildRangeIndex<Type>()` builds `index` over `data` in parallel, with blocks of `blockSize` elements (0 means
+ *   `FIND_MIN_DEFAULT_RANGE_BLOCK_SIZE`), and returns 0 - or -1 if memory runs out. `findMinFreeRangeIndex<Type>()`
+ *   frees it.
+ * `findMinRange<Type>()` returns the minimum of the elements `[begin, end)` (`highest` if there are none), scanning at
+ *   most two partial blocks and reading two table entries. `findMinRanges<Type>()` answers `count` such queries in
+ *   parallel, storing the minimum of `[begins[i], ends[i])` in `minima[i]`.
+ * `FindMinTree<Type>` keeps the minima of `data` up to date as it changes: a flat, implicit tree whose leaves hold the
+ *   minima of blocks of `FIND_MIN_TREE_LEAF_SIZE` elements and whose inner nodes hold those of `FIND_MIN_TREE_FANOUT`
+ *   children. Level `level` is stored in `nodes[levelOffsets[level], levelOffsets[level + 1])`, the root last, in a
+ *   little over `size / FIND_MIN_TREE_LEAF_SIZE` elements of memory. `data` must outlive it, and must only be changed
+ *   through it.
+ * `findMinBuildTree<Type>()` builds `tree` over `data` in parallel, and returns 0 - or -1 if memory runs out.
+ *   `findMinFreeTree<Type>()` frees it.
+ * `findMinTreeMin<Type>()` returns the minimum of `data`, and `findMinTreeRange<Type>()` that of the elements
+ *   `[begin, end)` - `highest` if there are none.
+ * `findMinTreeUpdate<Type>()` sets `data[index]` (`index` must be less than `size`) to `value`, and recomputes the
+ *   nodes above it, stopping at the first one that does not change. `findMinTreeUpdates<Type>()` sets
+ *   `data[indices[i]]` to `values[i]` for each of `count` updates, in order, then recomputes every node they changed
+ *   in parallel, level by level. Neither may run concurrently with any other use of `tree`.
+ */
+#define FIND_MIN_DECLARE(suffix, type, lowest, highest, sumType)                                                       \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    unsigned statistics;                                                                                               \
+    type threshold;                                                                                                    \
+    type histogramLow;                                                                                                 \
+    type histogramHigh;                                                                                                \
+    size_t binCount;                                                                                                   \
+    size_t * bins;                                                                                                     \
+    type minimum;                                                                                                      \
+    type maximum;                                                                                                      \
+    sumType sum;                                                                                                       \
+    size_t countBelow;                                                                                                 \
+  } FindMinReduction##suffix;                                                                                          \
+                                                                                                                       \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    type const * data;                                                                                                 \
+    size_t size;                                                                                                       \
+    size_t blockSize;                                                                                                  \
+    size_t blockCount;                                                                                                 \
+    size_t levelCount;                                                                                                 \
+    type * table;                                                                                                      \
+  } FindMinRangeIndex##suffix;                                                                                         \
+                                                                                                                       \
+  typedef struct                                                                                                       \
+  {                                                                                                                    \
+    type * data;                                                                                                       \
+    size_t size;                                                                                                       \
+    size_t levelCount;                                                                                                 \
+    size_t levelOffsets[FIND_MIN_TREE_MAX_LEVELS + 1];                                                                 \
+    type * nodes;                                                                                                      \
+    unsigned char * dirty;                                                                                             \
+  } FindMinTree##suffix;                                                                                               \
+                                                                                                                       \
+  size_t findArgMin##suffix(type const * data, size_t size, FindMinOptions const * options);                           \
+  size_t findFirstBelow##suffix(type const * data, size_t size, type threshold, FindMinOptions const * options);       \
+  type findMin##suffix(type const * data, size_t size, FindMinOptions const * options);                                \
+  int findMinBuildRangeIndex##suffix(FindMinRangeIndex##suffix * index, type const * data, size_t size,                \
+                                     size_t blockSize, FindMinOptions const * options);                                \
+  int findMinBuildTree##suffix(FindMinTree##suffix * tree, type * data, size_t size, FindMinOptions const * options);  \
+  void findMinFreeRangeIndex##suffix(FindMinRangeIndex##suffix * index);                                               \
+  void findMinFreeTree##suffix(FindMinTree##suffix * tree);                                                            \
+  type findMinKernel##suffix(type const * data, size_t size);                                                          \
+  type findMinKernelUntil##suffix(type const * data, size_t size, type sentinel);                                      \
+  void findMinReduce##suffix(type const * data, size_t size, FindMinReduction##suffix * reduction,                     \
+                             FindMinOptions const * options);                                                          \
+  type findMinRange##suffix(FindMinRangeIndex##suffix const * index, size_t begin, size_t end);                        \
+  void findMinRanges##suffix(FindMinRangeIndex##suffix const * index, size_t const * begins, size_t const * ends,      \
+                             size_t count, type * minima, FindMinOptions const * options);                             \
+  type findMinTreeMin##suffix(FindMinTree##suffix const * tree);                                                       \
+  type findMinTreeRange##suffix(FindMinTree##suffix const * tree, size_t begin, size_t end);                           \
+  void findMinTreeUpdate##suffix(FindMinTree##suffix * tree, size_t index, type value);                                \
+  void findMinTreeUpdates##suffix(FindMinTree##suffix * tree, size_t const * indices, type const * values,             \
+                                  size_t count, FindMinOptions const * options);                                       \
+  type findMinUntil##suffix(type const * data, size_t size, type sentinel, FindMinOptions const * options);            \
+  size_t findSmallest##suffix(type const * data, size_t size, size_t k, type * values, size_t * indices,               \
+                              FindMinOptions const * options);
+
+FIND_MIN_TYPES(FIND_MIN_DECLARE)
+
+/**
+ * Returns the name of the `int32_t` kernel chosen for this CPU ("avx512", "avx2", "sse4.1" or "scalar").
+ */
+char const * findMinKernelName(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIND_MIN_H
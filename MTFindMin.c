@@ -9,32 +9,227 @@
 // Tested on: macOS 10.14 (partially - macOS does not support unnamed POSIX semaphores), CentOS 6.10 (athena)
 //===--------------------------------------------------------------------------------------------------------------===//
 
+// For `pthread_attr_setaffinity_np()` and the `CPU_*` macros
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
 #include <limits.h>
+#include <math.h>
+#include <poll.h>
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
+#include <signal.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/timeb.h>
+#include <string.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <linux/perf_event.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#endif
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#define HAVE_X86_PAUSE 1
+#endif
+
+#include "FindMin.h"
 
-#define MAX_ARRAY_SIZE 100000000
-#define MAX_THREAD_COUNT 16
 #define RANDOM_SEED 7665
 #define MAX_RANDOM_NUMBER 5000
+// Passed as `indexOfZero` to place no zero in the generated input
+#define NO_ZERO SIZE_MAX
+// Greatest number of threads a search may be asked to use
+#define MAX_THREAD_COUNT 4096
+// Size of the huge pages input arrays are backed by, when available
+#define HUGE_PAGE_SIZE ((size_t) 2 << 20)
+// Size of the ordinary pages `touchRegion` writes to once each
+#define SMALL_PAGE_SIZE ((size_t) 4 << 10)
+// Default number of elements handed to the min kernel between checks of the stop flag (64 KiB of `int`)
+#define FIND_MIN_CHUNK_SIZE FIND_MIN_DEFAULT_CHUNK_SIZE
+// Array sizes swept by `benchmarkThreadPool`
+#define POOL_BENCHMARK_MIN_SIZE 10000
+#define POOL_BENCHMARK_MAX_SIZE 100000000
+// Total number of elements `benchmarkThreadPool` scans per array size and strategy (bounds the number of queries)
+#define POOL_BENCHMARK_ELEMENTS 1000000000
+// Default number of integers read into each buffer by `searchStream` (256 KiB)
+#define STREAM_BLOCK_SIZE 65536
+// Default number of buffers in `searchStream`'s ring, per worker thread
+#define STREAM_BUFFERS_PER_THREAD 4
+// Pushed onto a `SlotQueue` in place of a slot index to tell the stream workers to exit
+#define END_OF_STREAM SIZE_MAX
+// Size of a cache line, which the parts of `ThreadInfo` written by different threads are kept apart by
+#define CACHE_LINE_SIZE 64
+// Most `pause` instructions `backOff` spins for between polls before it starts yielding the CPU instead
+#define BACKOFF_SPIN_LIMIT 1024
+// Number of timed searches `benchmarkMonitor` runs per case
+#define MONITOR_BENCHMARK_REPETITIONS 20
+// Defaults for `runBenchmark`
+#define BENCHMARK_SIZES "1000,100000,10000000"
+#define BENCHMARK_THREAD_COUNTS "1,2,4"
+#define BENCHMARK_ZEROS "none,middle"
+#define BENCHMARK_REPETITIONS 20
+#define BENCHMARK_WARMUP 2
+// Number of timed searches `benchmarkContention` runs per scheduler - enough that its p99 is not just the maximum
+#define CONTENTION_BENCHMARK_REPETITIONS 200
+// Every how many spins a hog started by `startHog` checks that its parent is still alive
+#define HOG_PARENT_CHECK_INTERVAL (1UL << 20)
+// Number of timed passes `searchStatistics` runs per case, and the number of bins in its histogram
+#define STATISTICS_REPETITIONS 10
+#define STATISTICS_BIN_COUNT 10
+// Number of `--ranges` queries also answered by scanning, to time and check the range index against
+#define RANGE_SCAN_SAMPLES 1000
+// Largest number of threads `benchmarkCompletion` measures (starting at 1 and doubling)
+#define COMPLETION_BENCHMARK_MAX_THREADS 128
+// Number of wake-ups `benchmarkCompletion` times per thread count and primitive
+#define COMPLETION_BENCHMARK_REPETITIONS 100
+// Every how many searches `--async` cancels one right after submitting it
+#define ASYNC_CANCEL_INTERVAL 10
+// Number of elements above which a batch job is split into one region per worker, rather than searched whole (4 MiB)
+#define BATCH_SPLIT_SIZE ((size_t) 1 << 20)
+// The workload `--batch` runs without a workload file: this many jobs, log-uniformly between 4 KiB and 64 MiB
+#define BATCH_DEFAULT_JOB_COUNT 1000
+#define BATCH_DEFAULT_MIN_BYTES ((size_t) 4 << 10)
+#define BATCH_DEFAULT_MAX_BYTES ((size_t) 64 << 20)
+// Greatest number of pinned CPUs `--affinity` lists when it reports the placement
+#define AFFINITY_REPORTED_CPUS 32
+// Version of the tuning profile format, which profiles of other versions are recalibrated rather than read in
+#define TUNING_PROFILE_VERSION 2
+// Greatest number of thread counts the scaling curve of a tuning profile has points for
+#define TUNING_MAX_POINTS 32
+// Size of the array `calibrateHost` measures bandwidth on (64 MiB, well beyond the last level cache)
+#define CALIBRATION_SIZE ((size_t) 1 << 24)
+// Number of timed searches `calibrateHost` runs per bandwidth measurement (keeping the best) and per latency one
+#define CALIBRATION_BANDWIDTH_REPETITIONS 5
+#define CALIBRATION_LATENCY_REPETITIONS 50
+// Chunk sizes `calibrateHost` chooses between: the smallest whose full search plus stop latency is within
+// `CALIBRATION_CHUNK_TOLERANCE` of the lowest
+#define CALIBRATION_CHUNK_SIZES { 1024, 4096, 16384, 65536, 262144 }
+#define CALIBRATION_CHUNK_TOLERANCE 1.02
+// Defaults for `runRegression`
+#define REGRESSION_SIZES "100000,10000000"
+#define REGRESSION_THREAD_COUNT 4
+#define REGRESSION_REPETITIONS 10
+#define REGRESSION_THRESHOLD 10.0
+// Number of zeros `fillBoundaryZeros` places on each side of every boundary between slices
+#define BOUNDARY_ZERO_CLUSTER 8
+
+/**
+ * The hardware and software events counted by `PerfCounters`.
+ */
+enum
+{
+  PERF_CYCLES,
+  PERF_INSTRUCTIONS,
+  PERF_LLC_MISSES,
+  PERF_CONTEXT_SWITCHES,
+  PERF_CPU_MIGRATIONS,
+  PERF_COUNTER_COUNT
+};
+
+/**
+ * Performance counters for one thread, opened with `perf_event_open`.
+ * `fds[i]` is the counter's file descriptor while counting, or -1 if the counter could not be opened.
+ * `values[i]` is the count, and `available[i]` tells whether it was actually counted - counters are often unavailable
+ * in containers and VMs, or when `perf_event_paranoid` forbids them. When there are more counters than the PMU can
+ * count at once, the kernel multiplexes them, and `values[i]` is scaled up from the time the counter actually ran to
+ * the time it was enabled.
+ */
+typedef struct
+{
+  int fds[PERF_COUNTER_COUNT];
+  uint64_t values[PERF_COUNTER_COUNT];
+  bool available[PERF_COUNTER_COUNT];
+} PerfCounters;
+
+/**
+ * A one-shot completion that a thread can wait on until `count` others have arrived at it, or one of them signals it
+ * early. Arriving is a lock-free countdown; the waiter is only woken (with a futex on Linux) by the signal, and only
+ * enters the kernel to wake it if it is actually asleep.
+ * `remaining` is the number of arrivals left before the completion is signalled.
+ * `state` is `COMPLETION_PENDING`, `COMPLETION_SLEEPING` once the waiter is (about to be) asleep on it, or
+ * `COMPLETION_SIGNALLED`.
+ * Both are accessed only through the `__atomic` builtins. Should be initialized with `initCompletion()`.
+ */
+typedef struct
+{
+  size_t remaining;
+  int state;
+} Completion;
+
+enum
+{
+  COMPLETION_PENDING,
+  COMPLETION_SLEEPING,
+  COMPLETION_SIGNALLED,
+};
+
+/**
+ * What the workers of the `barrier`, `condition` and `eventfd` search modes tell their parent they are done with.
+ * Each mode initializes only the primitive it uses:
+ * `barrier` is waited at by every worker once it is done, and by the parent.
+ * `remaining` counts the workers still searching, and `signalled` is set once the last one is done or one finds a
+ * zero; both are protected by `mutex`, and the parent waits on `changed` for `signalled`.
+ * `eventFd` is an eventfd the workers add 1 to once done (or the thread count, if they found a zero), which the parent
+ * reads until it has counted every worker.
+ */
+typedef struct
+{
+  pthread_barrier_t barrier;
+  pthread_mutex_t mutex;
+  pthread_cond_t changed;
+  size_t remaining;
+  bool signalled;
+  int eventFd;
+} WakeChannel;
 
 /**
  * The shared state of all threads - should be instantiated once and passed to each `ThreadInfo` instance.
- * `searchDone` is a binary semaphore that signals when all threads are done, or one finds a zero.
- * `doneThreadCountMutex` is a binary semaphore which acts as a mutex to protect access to `doneThreadCount`.
- * `doneThreadCount` is the number of threads that are done searching.
+ * `searchDone` is signalled when all threads are done (each arrives at it), or one finds a zero.
+ * `stop` is set once the search should end early (a zero was found, or the parent cancelled the search). Workers check
+ * it once per chunk of `chunkSize` elements.
+ * `zeroFoundTime` is the `now()` timestamp at which the first zero was found, or 0 if none was found.
+ * `lastStopTime` is the `now()` timestamp at which the last worker stopped.
+ * `observedTime` is the `now()` timestamp at which the parent saw that the search was over, or 0 if the search mode
+ * does not record it. `wakeLatency()` is the time from `zeroFoundTime` (or `lastStopTime`) to it.
+ * `channel` is the primitive the workers of the search modes that use a `WakeChannel` signal their parent through.
+ * `stopOnZero` is `true` for the early-zero-exit search, and `false` for a full reduction over every element.
+ * `threadInfo` is the array of `threadCount` threads sharing this state (set by `computeThreadInfo()`), which
+ * `findMinDynamic` steals chunks from.
+ * `perf` is an array of `threadCount` counters, one per thread, or `NULL` if the threads should not be instrumented.
+ * `stop`, `zeroFoundTime` and `lastStopTime` are accessed only through the `__atomic` builtins.
  */
 typedef struct
 {
-  sem_t searchDone;
-  sem_t doneThreadCountMutex;
-  size_t doneThreadCount;
+  Completion searchDone;
   size_t threadCount;
+  size_t chunkSize;
+  int stop;
+  uint64_t zeroFoundTime;
+  uint64_t lastStopTime;
+  uint64_t observedTime;
+  bool stopOnZero;
+  WakeChannel * channel;
+  struct ThreadInfo * threadInfo;
+  PerfCounters * perf;
 } SharedState;
 
 /**
@@ -43,418 +238,5123 @@ typedef struct
  * `data` is the array the thread is searching
  * `minimum` tracks the minimum value found by the thread
  * `region` tracks the region that the thread should search
- * Should be initialized with `initThreadInfo()`.
+ * `nextIndex` is the start of the next unclaimed chunk of the region, when chunks are claimed dynamically by
+ * `findMinDynamic`
+ * `done` and `minimum` are the thread's result slot: they are published with release stores once the thread is done,
+ * read with acquire loads, and sit on a cache line of their own so that a parent polling them does not slow down the
+ * thread, or its neighbours. `nextIndex` (accessed only through the `__atomic` builtins) has its own line as well.
+ * Should be initialized with `computeThreadInfo()`, which allocates it aligned to a cache line.
  */
-typedef struct
+typedef struct ThreadInfo
 {
-  volatile bool done;
-  int const * data;
-  volatile int minimum;
+  bool done;
+  int minimum;
+  int const * data __attribute__((aligned(CACHE_LINE_SIZE)));
   size_t begin_region;
   size_t end_region;
   SharedState * sharedState;
   pthread_t threadHandle;
+  size_t nextIndex __attribute__((aligned(CACHE_LINE_SIZE)));
 } ThreadInfo;
 
+struct ThreadPool;
+
+/**
+ * Identifies one worker of a `ThreadPool`.
+ * `index` is the index of the `ThreadInfo` this worker runs for each job.
+ */
+typedef struct
+{
+  struct ThreadPool * pool;
+  size_t index;
+  pthread_t threadHandle;
+} PoolWorker;
+
+/**
+ * A set of long-lived threads that run searches over `ThreadInfo` regions without being created and joined per search.
+ * `mutex` protects every other field.
+ * `wake` is signalled when a new job is posted (`generation` changes) or the pool shuts down.
+ * `jobDone` is signalled when the last worker finishes the current job (`pending` reaches 0).
+ * `threadInfo` and `f` describe the current job - worker `i` runs `f(&threadInfo[i])`.
+ * Should be created with `createThreadPool()` and destroyed with `destroyThreadPool()`.
+ */
+typedef struct ThreadPool
+{
+  pthread_mutex_t mutex;
+  pthread_cond_t wake;
+  pthread_cond_t jobDone;
+  size_t generation;
+  size_t pending;
+  bool shutdown;
+  ThreadInfo * threadInfo;
+  void * (* f)(void *);
+  size_t threadCount;
+  PoolWorker * workers;
+} ThreadPool;
+
+/**
+ * A blocking FIFO of buffer slot indices, used to pass buffers between the reader and the workers of a stream search.
+ * `items` counts the slots in the queue; `mutex` protects `head` and `tail`. The queue can never overflow, because
+ * there are only `capacity` slots to go around.
+ */
+typedef struct
+{
+  pthread_mutex_t mutex;
+  sem_t items;
+  size_t * slots;
+  size_t capacity;
+  size_t head;
+  size_t tail;
+} SlotQueue;
+
+/**
+ * The state of a streaming search, shared by its reader thread and its worker threads.
+ * `buffers` is a ring of `bufferCount` buffers of `blockSize` integers each - the only memory the search uses for data.
+ * `blockLengths[i]` is the number of integers in buffer `i`.
+ * Empty buffers wait in `freeSlots`, and filled ones in `filledSlots`.
+ * `wakePipe` is written to when a zero is found, to interrupt the reader if it is blocked waiting for input.
+ * `minimum` is the running minimum of every block searched so far, and `elementCount` is the number of integers read
+ * (both accessed only through the `__atomic` builtins).
+ */
+typedef struct
+{
+  int fd;
+  int wakePipe[2];
+  size_t blockSize;
+  size_t bufferCount;
+  int * buffers;
+  size_t * blockLengths;
+  SlotQueue freeSlots;
+  SlotQueue filledSlots;
+  SharedState * sharedState;
+  int minimum;
+  size_t elementCount;
+} StreamState;
+
+/**
+ * A way of searching `data` for its minimum, as run by `main()` and `runBenchmark()`.
+ * `name` identifies the mode in benchmark output, and `description` in `main()`'s output.
+ * `search` returns the minimum of the `size` elements of `data`. Threaded modes search with
+ * `sharedState->threadCount` threads, and those that run on a pool use `pool`, which has that many threads. Modes whose
+ * parent waits for its threads set `sharedState->observedTime` once it sees that the search is over.
+ */
+typedef struct
+{
+  char const * name;
+  char const * description;
+  int (* search)(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+} SearchMode;
+
+/**
+ * Summary statistics of a set of timings, in nanoseconds. Filled in by `computeStatistics()`.
+ */
+typedef struct
+{
+  double min;
+  double median;
+  double p90;
+  double p99;
+  double max;
+  double mean;
+  double stddev;
+} Statistics;
+
+/**
+ * The state shared by the threads of one `benchmarkCompletion()` round, which all arrive at once at either `completion`
+ * or the semaphore-based equivalent (`done`, posted by whichever thread increments `doneCount` to `threadCount` under
+ * `doneCountMutex`).
+ * `start` lines the threads up so that they arrive together.
+ * `lastArrivalTime` is the `now()` timestamp at which the last thread arrived (accessed only through the `__atomic`
+ * builtins).
+ */
+typedef struct CompletionBenchmark
+{
+  pthread_barrier_t start;
+  uint64_t lastArrivalTime;
+  Completion completion;
+  sem_t done;
+  sem_t doneCountMutex;
+  size_t doneCount;
+  size_t threadCount;
+} CompletionBenchmark;
+
+/**
+ * An array of `int`s stored in as few bytes per element as their range allows.
+ * `width` is the number of bytes each of the `size` elements at `values` takes: 1 (`uint8_t`), 2 (`uint16_t`) or
+ * `sizeof(int)`.
+ * `base` is added to each stored element to get the value it stands for - 0, unless the values have to be shifted down
+ * to fit in `width` bytes.
+ */
+typedef struct
+{
+  void * values;
+  size_t size;
+  size_t width;
+  int base;
+} PackedInput;
+
+/**
+ * A search submitted with `submitSearch()`, which runs on threads of its own while the submitter gets on with other
+ * work.
+ * `sharedState` is the first member, so that a worker can get from its `ThreadInfo` back to the search.
+ * `eventFd` becomes readable once the search is done - it is an eventfd on Linux, and the read end of a pipe elsewhere,
+ * whose write end is `signalFd` (the same descriptor as `eventFd` on Linux).
+ * `running` is the number of workers still searching, accessed only through the `__atomic` builtins. The last worker
+ * to finish signals `eventFd`.
+ */
+typedef struct
+{
+  SharedState sharedState;
+  ThreadInfo * threadInfo;
+  int eventFd;
+  int signalFd;
+  size_t running;
+} AsyncSearch;
+
+/**
+ * Where a CPU sits in the machine's topology, as read from /sys by `discoverTopology()`.
+ * `thread` is the CPU's index among the SMT siblings of its core (0 for the first), and `coreRank` the index of its
+ * core among those of its NUMA node.
+ */
+typedef struct
+{
+  int cpu;
+  int node;
+  int socket;
+  int core;
+  int thread;
+  int coreRank;
+} CpuInfo;
+
+/**
+ * The thread placement policies of `--affinity`.
+ * `PLACEMENT_COMPACT` fills one core after another (SMT siblings first), node by node.
+ * `PLACEMENT_SCATTER` spreads consecutive threads across nodes, then across the cores of each node, before using SMT
+ * siblings.
+ * `PLACEMENT_PHYSICAL` is `PLACEMENT_COMPACT` with one CPU per physical core.
+ */
+enum
+{
+  PLACEMENT_COMPACT,
+  PLACEMENT_SCATTER,
+  PLACEMENT_PHYSICAL,
+};
+
+/**
+ * One independent array searched by `runBatch()`.
+ * `minimum` is the minimum of the regions searched so far, and `remaining` the number of its tasks not yet done - both
+ * accessed only through the `__atomic` builtins.
+ * `startTime` is when a worker first popped one of its tasks off the queue (accessed only through the `__atomic`
+ * builtins, and 0 until then), and `latency` the time from `submitTime` until its last task was done, so that
+ * `startTime - submitTime` is the time the job spent queued behind others.
+ */
+typedef struct
+{
+  int const * data;
+  size_t size;
+  int minimum;
+  size_t remaining;
+  uint64_t submitTime;
+  uint64_t startTime;
+  uint64_t latency;
+} BatchJob;
+
+/**
+ * A region `[begin, end)` of a `BatchJob`, searched whole by one worker.
+ */
+typedef struct
+{
+  BatchJob * job;
+  size_t begin;
+  size_t end;
+} BatchTask;
+
+/**
+ * The state shared by the workers of `runBatch()`: the `tasks` of every job, and the `queue` of the indices of those
+ * submitted so far, ended by one `END_OF_STREAM` per worker.
+ */
+typedef struct
+{
+  BatchTask * tasks;
+  SlotQueue queue;
+} BatchEngine;
+
+/**
+ * What `calibrateHost()` measured about this host, from which `chooseTuning()` predicts the fastest way to search an
+ * array of any size. Cached in a file between runs by `getTuningProfile()`, and recalibrated if `cpuCount` or `kernel`
+ * no longer match the host.
+ * `sequentialBandwidth` is the bandwidth of `findMinSequential()`, in bytes per nanosecond (GB/s).
+ * `spawnCost` and `wakeCost` are the time taken per thread to create and join threads, and to wake the workers of a
+ * `ThreadPool` and wait for them, in nanoseconds.
+ * `chunkSize` is the smallest chunk size that (nearly) minimizes the time of a full search plus the time the other
+ * threads take to stop once one finds a zero: larger chunks search faster, but are checked for a stop less often.
+ * `bandwidths[i]` is the bandwidth of `searchJoined()` on `threadCounts[i]` threads once its `spawnCost` is taken
+ * out, for each of `pointCount` thread counts: the powers of two up to `cpuCount`, and `cpuCount` itself.
+ */
+typedef struct
+{
+  size_t cpuCount;
+  char kernel[16];
+  double sequentialBandwidth;
+  double spawnCost;
+  double wakeCost;
+  size_t chunkSize;
+  size_t pointCount;
+  size_t threadCounts[TUNING_MAX_POINTS];
+  double bandwidths[TUNING_MAX_POINTS];
+} TuningProfile;
+
+/**
+ * A named shape of input data, as generated by `generateScenario()` for `runRegression()`.
+ * `fill` overwrites the `size` elements of `data` with the scenario's values for `seed`, laid out for a search on
+ * `threadCount` threads. Every value is between 0 and `MAX_RANDOM_NUMBER`.
+ */
+typedef struct
+{
+  char const * name;
+  char const * description;
+  void (* fill)(int * data, size_t size, uint64_t seed, size_t threadCount);
+} Scenario;
+
+/**
+ * The throughput of one case of a regression baseline, as read by `loadBaseline()`.
+ */
+typedef struct
+{
+  char scenario[32];
+  size_t size;
+  size_t threadCount;
+  char mode[32];
+  double gigabytesPerSecond;
+} BaselineEntry;
+
+int * allocateInput(size_t size, size_t threadCount, void * (* touch)(void *));
 bool allThreadsDone(size_t threadCount, ThreadInfo const * threadInfo);
-void cancelAll(ThreadInfo * threadInfo, size_t threadCount);
+void arriveAtCompletion(Completion * completion);
+void * asyncSearchThread(void * threadInfo);
+void backOff(unsigned * spins);
+void * batchWorkerMain(void * engine);
+void benchmarkCompletion();
+void benchmarkContention(size_t arraySize, size_t threadCount, size_t hogCount);
+void benchmarkMonitor(size_t arraySize, size_t threadCount);
+void benchmarkThreadPool(int const * data, size_t threadCount);
+void calibrateHost(TuningProfile * profile);
+void cancelAll(SharedState * sharedState);
+void cancelSearch(AsyncSearch * search);
+bool chooseTuning(TuningProfile const * profile, size_t arraySize, size_t * threadCount, size_t * chunkSize,
+                 bool * pooled);
+int compareCompact(void const * a, void const * b);
+int compareScatter(void const * a, void const * b);
+int compareUint64(void const * a, void const * b);
+Statistics computeStatistics(uint64_t * samples, size_t count);
 ThreadInfo * computeThreadInfo(int const * data, size_t arraySize, size_t threadCount, SharedState * sharedState);
-int findMinInRegion(int const * data, size_t begin, size_t end);
+ThreadPool * createThreadPool(size_t threadCount);
+void destroyThreadPool(ThreadPool * pool);
+size_t discoverTopology(CpuInfo ** cpus);
+bool fetchSearchResult(AsyncSearch * search, int * minimum);
+void fillBoundaryZeros(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillDuplicates(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillLastZero(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillNoZero(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillReverseSorted(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillSorted(int * data, size_t size, uint64_t seed, size_t threadCount);
+void fillUniformZero(int * data, size_t size, uint64_t seed, size_t threadCount);
+void * findMinDynamic(void * threadInfo);
+int findMinInChunk(int const * data, size_t size, bool stopOnZero);
+int findMinInRegion(int const * data, size_t begin, size_t end, SharedState * sharedState);
+int findMinPacked(PackedInput const * packed, FindMinOptions const * options);
 int findMinSequential(int const * data, size_t size);
 void * findMinThreaded(void * region);
+void * findMinThreadedWithBarrier(void * threadInfo);
+void * findMinThreadedWithCondition(void * threadInfo);
+void * findMinThreadedWithEventFd(void * threadInfo);
 void * findMinThreadedWithSemaphore(void * threadInfo);
-void freeSharedState(SharedState * sharedState);
-int * generateInput(size_t size, int indexOfZero);
-SharedState initSharedState(size_t threadCount);
+void freeInput(int * data, size_t size);
+void freePackedInput(PackedInput * packed);
+void freeSlotQueue(SlotQueue * queue);
+int * generateInput(size_t size, size_t indexOfZero, size_t threadCount);
+void * generateRegion(void * threadInfo);
+int * generateScenario(Scenario const * scenario, size_t size, uint64_t seed, size_t threadCount);
+void getTuningProfile(TuningProfile * profile, bool recalibrate);
+SharedState initSharedState(size_t threadCount, size_t chunkSize);
+void initCompletion(Completion * completion, size_t count);
+void initSlotQueue(SlotQueue * queue, size_t capacity);
+void initThreadAttr(pthread_attr_t * attr, size_t index);
 void joinAll(ThreadInfo const * threadInfo, size_t threadCount);
-time_t now();
+size_t loadBaseline(char const * path, BaselineEntry ** entries);
+bool loadTuningProfile(TuningProfile * profile, char const * path);
+void mergePerfCounters(PerfCounters * total, PerfCounters const * part);
+int const * mapInputFile(char const * path, size_t * size, bool dropCache);
+void monitorThreads(ThreadInfo * threadInfo, SharedState * sharedState, bool useBackOff);
+uint64_t now();
+void packInput(PackedInput * packed, int const * data, size_t size, int lowest, int highest);
+size_t parseArraySize(char const * str);
+size_t parseBlockSize(char const * str);
+size_t parseBufferCount(char const * str);
+size_t parseChunkSize(char const * str);
+size_t parseCpuList(char const * str, int ** cpus);
+size_t parseList(char const * str, size_t ** values, size_t (* parse)(char const *));
+size_t parseQueryCount(char const * str);
+size_t parseRepetitions(char const * str);
+size_t parseSearchCount(char const * str);
+uint64_t parseSeed(char const * str);
+bool * parseSelection(char const * str, void const * items, size_t itemCount, size_t itemSize, char const * kind);
+size_t parseSmallestCount(char const * str);
+size_t parseThreadCount(char const * str);
+double parseThreshold(char const * str);
+size_t parseUpdateCount(char const * str);
+size_t parseWarmup(char const * str);
+size_t parseZeroPosition(char const * str);
+void perfBegin(PerfCounters * counters);
+void perfBeginThread(ThreadInfo const * threadInfo);
+void perfEnd(PerfCounters * counters);
+void perfEndThread(ThreadInfo const * threadInfo);
+bool pollSearch(AsyncSearch const * search);
+size_t popSlot(SlotQueue * queue);
+void poolJoinAll(ThreadPool * pool);
+void poolStartAll(ThreadPool * pool, ThreadInfo * threadInfo, void * (* f)(void *));
+void * poolWorkerMain(void * worker);
+void printPerfCounters(char const * label, PerfCounters const * counters);
+void printPerfReport(SharedState const * sharedState, PerfCounters const * parent, size_t bytes);
+void printStopLatency(SharedState const * sharedState);
+void printTuningProfile(TuningProfile const * profile);
+void printUsage(void);
+void pushSlot(SlotQueue * queue, size_t slot);
+uint64_t randomBits(uint64_t seed, uint64_t index);
+int randomValue(uint64_t seed, uint64_t index);
+bool readSysFile(char const * path, char * buffer, size_t size);
+int readSysInt(char const * path, int fallback);
+size_t readWorkload(char const * path, size_t ** sizes);
+void recordArrival(CompletionBenchmark * benchmark);
+void reportStopped(SharedState * sharedState);
+void reportZero(SharedState * sharedState);
+int runBenchmark(int argc, char const ** argv);
+int runRegression(int argc, char const ** argv);
+void runBatch(BatchJob * jobs, size_t jobCount, size_t threadCount);
+bool saveTuningProfile(TuningProfile const * profile, char const * path);
+int searchAsync(size_t arraySize, size_t threadCount, size_t searchCount);
+int searchBatch(size_t threadCount, char const * path);
+int searchBusyWaiting(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchCompact(size_t arraySize, size_t threadCount, size_t indexOfZero, int maxValue);
+int searchDynamic(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+void searchFile(char const * path, size_t threadCount, size_t chunkSize);
+int searchFirstBelow(size_t arraySize, size_t threadCount);
+int searchJoined(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchLibrary(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchOnPool(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchRanges(size_t arraySize, size_t threadCount, size_t queryCount);
+int searchSequential(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchSmallest(size_t arraySize, size_t threadCount, size_t k);
+int searchStatistics(size_t arraySize, size_t threadCount);
+void searchStream(char const * path, size_t threadCount, size_t blockSize, size_t bufferCount);
 int searchThreadMinima(size_t threadCount, ThreadInfo const * threadInfo);
+int searchUpdates(size_t arraySize, size_t threadCount, size_t updateCount);
+int searchWithBarrier(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchWithCondition(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchWithEventFd(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchWithSemaphore(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+int searchWithSpinFutex(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool);
+void setPlacement(char const * policy);
+void signalCompletion(Completion * completion);
+pid_t startHog();
 void startAll(ThreadInfo * threadInfo, size_t threadCount, void * (* f)(void *));
 int stoi(char const * str);
-time_t timeSince(time_t time);
+long long stoll(char const * str);
+void * streamReaderMain(void * streamState);
+void * streamWorkerMain(void * streamState);
+AsyncSearch * submitSearch(int const * data, size_t size, size_t threadCount, size_t chunkSize);
+void * timeCompletionArrival(void * benchmark);
+void * timeSemaphoreArrival(void * benchmark);
+uint64_t timeSince(uint64_t time);
+void * touchRegion(void * threadInfo);
+bool tuningProfilePath(char * path, size_t size);
+void waitForCompletion(Completion * completion);
+void waitForCompletionSpinning(Completion * completion);
+uint64_t wakeLatency(SharedState const * sharedState);
+void writeInputFile(char const * path, int const * data, size_t size);
+
+SearchMode const searchModes[] = {
+  {"sequential", "Sequential search", searchSequential},
+  {"joined", "Threaded search with parent waiting for all children", searchJoined},
+  {"busy-wait", "Threaded search with parent continually checking on children", searchBusyWaiting},
+  {"semaphore", "Threaded search with parent waiting on a semaphore", searchWithSemaphore},
+  {"barrier", "Threaded search with parent waiting at a barrier", searchWithBarrier},
+  {"condition", "Threaded search with parent waiting on a condition variable", searchWithCondition},
+  {"spin-futex", "Threaded search with parent spinning, then sleeping on a futex", searchWithSpinFutex},
+  {"eventfd", "Threaded search with parent reading an eventfd", searchWithEventFd},
+  {"dynamic", "Threaded search with dynamic work stealing", searchDynamic},
+  {"pool", "Threaded search on a persistent thread pool", searchOnPool},
+  {"library", "Threaded search with the FindMin library", searchLibrary},
+};
+size_t const searchModeCount = sizeof(searchModes) / sizeof(searchModes[0]);
+
+Scenario const scenarios[] = {
+  {"uniform-zero", "Uniform values with one zero at a random index", fillUniformZero},
+  {"no-zero", "Uniform values with no zero", fillNoZero},
+  {"sorted", "Ascending values, starting at zero", fillSorted},
+  {"reverse-sorted", "Descending values, ending at zero", fillReverseSorted},
+  {"duplicates", "Only the values 1 to 4, with no zero", fillDuplicates},
+  {"boundary-zeros", "Uniform values with zeros clustered around each boundary between slices", fillBoundaryZeros},
+  {"last-zero", "Uniform values with a zero at the last element of the last slice", fillLastZero},
+};
+size_t const scenarioCount = sizeof(scenarios) / sizeof(scenarios[0]);
+
+/**
+ * The CPUs that the threads created by `startAll()`, `createThreadPool()` and `runBatch()` are pinned to: thread `i`
+ * runs on `threadCpus[i % threadCpuCount]`. Empty by default, which leaves placement to the kernel. Set once, by
+ * `setPlacement()`.
+ */
+int * threadCpus = NULL;
+size_t threadCpuCount = 0;
 
-int main(const int argc, const char ** argv)
+int main(int argc, const char ** argv)
 {
-  if (argc != 4)
+  bool instrument = false;
+  while (argc >= 2 && (strcmp(argv[1], "--perf") == 0 || strncmp(argv[1], "--affinity=", 11) == 0))
   {
-    fprintf(stderr, "%s%s%s%s%s",
-            "Usage: MTFindMin <array_size> <num_threads> <index_of_zero>\n",
-            "array_size: The size of the array to be searched\n",
-            "num_threads: The number of threads to use\n",
-            "index_of_zero: The index in the array at which to place the zero. ",
-            "If -1, no zero will be placed.\n");
-    exit(-1);
+    if (strcmp(argv[1], "--perf") == 0)
+    {
+      instrument = true;
+    }
+    else
+    {
+      setPlacement(argv[1] + 11);
+    }
+    --argc;
+    ++argv;
   }
-  int arraySize = stoi(argv[1]);
-  if (arraySize <= 0 || arraySize > MAX_ARRAY_SIZE)
+  if (instrument && argc >= 2 && strncmp(argv[1], "--", 2) == 0)
   {
-    fprintf(stderr, "array_size must be between 1 and %d\n", MAX_ARRAY_SIZE);
+    // Only the default search is instrumented
+    printUsage();
     exit(-1);
   }
-  int threadCount = stoi(argv[2]);
-  if (threadCount > MAX_THREAD_COUNT || threadCount < 1)
+  if (argc >= 2 && strcmp(argv[1], "--benchmark") == 0)
+  {
+    return runBenchmark(argc - 1, argv + 1);
+  }
+  if (argc >= 2 && strcmp(argv[1], "--regress") == 0)
+  {
+    return runRegression(argc - 1, argv + 1);
+  }
+  if (argc == 3 && strcmp(argv[1], "--benchmark-pool") == 0)
+  {
+    size_t threadCount = parseThreadCount(argv[2]);
+    int * data = generateInput(POOL_BENCHMARK_MAX_SIZE, NO_ZERO, threadCount);
+    benchmarkThreadPool(data, threadCount);
+    freeInput(data, POOL_BENCHMARK_MAX_SIZE);
+    return 0;
+  }
+  if ((argc == 4 || argc == 5) && strcmp(argv[1], "--file") == 0)
+  {
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t chunkSize = argc == 5 ? parseChunkSize(argv[4]) : FIND_MIN_CHUNK_SIZE;
+    searchFile(argv[2], threadCount, chunkSize);
+    return 0;
+  }
+  if (argc >= 4 && argc <= 6 && strcmp(argv[1], "--stream") == 0)
+  {
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t blockSize = argc >= 5 ? parseBlockSize(argv[4]) : STREAM_BLOCK_SIZE;
+    size_t bufferCount = argc == 6 ? parseBufferCount(argv[5]) : STREAM_BUFFERS_PER_THREAD * threadCount;
+    searchStream(argv[2], threadCount, blockSize, bufferCount);
+    return 0;
+  }
+  if (argc == 5 && strcmp(argv[1], "--write-file") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[3]);
+    long long indexArgument = stoll(argv[4]);
+    if (indexArgument < -1 || indexArgument >= (long long) arraySize)
+    {
+      fprintf(stderr, "index_of_zero must be between -1 and %zu (array_size - 1)\n", arraySize - 1);
+      exit(-1);
+    }
+    int * data = generateInput(arraySize, indexArgument == -1 ? NO_ZERO : (size_t) indexArgument, 1);
+    writeInputFile(argv[2], data, arraySize);
+    freeInput(data, arraySize);
+    return 0;
+  }
+  if (argc == 5 && strcmp(argv[1], "--smallest") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t k = parseSmallestCount(argv[4]);
+    return searchSmallest(arraySize, threadCount, k);
+  }
+  if (argc == 5 && strcmp(argv[1], "--ranges") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t queryCount = parseQueryCount(argv[4]);
+    return searchRanges(arraySize, threadCount, queryCount);
+  }
+  if ((argc == 5 || argc == 6) && strcmp(argv[1], "--compact") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    long long indexArgument = stoll(argv[4]);
+    if (indexArgument < -1 || indexArgument >= (long long) arraySize)
+    {
+      fprintf(stderr, "index_of_zero must be between -1 and %zu (array_size - 1)\n", arraySize - 1);
+      exit(-1);
+    }
+    int maxValue = argc == 6 ? stoi(argv[5]) : 0;
+    if (argc == 6 && (maxValue < 1 || maxValue > MAX_RANDOM_NUMBER))
+    {
+      fprintf(stderr, "max_value must be between 1 and %d\n", MAX_RANDOM_NUMBER);
+      exit(-1);
+    }
+    return searchCompact(arraySize, threadCount, indexArgument == -1 ? NO_ZERO : (size_t) indexArgument, maxValue);
+  }
+  if ((argc == 3 || argc == 4) && strcmp(argv[1], "--batch") == 0)
+  {
+    size_t threadCount = parseThreadCount(argv[2]);
+    return searchBatch(threadCount, argc == 4 ? argv[3] : NULL);
+  }
+  if (argc == 5 && strcmp(argv[1], "--async") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t searchCount = parseSearchCount(argv[4]);
+    return searchAsync(arraySize, threadCount, searchCount);
+  }
+  if (argc == 4 && strcmp(argv[1], "--first-below") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    return searchFirstBelow(arraySize, threadCount);
+  }
+  if (argc == 5 && strcmp(argv[1], "--updates") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    size_t updateCount = parseUpdateCount(argv[4]);
+    return searchUpdates(arraySize, threadCount, updateCount);
+  }
+  if (argc == 4 && strcmp(argv[1], "--statistics") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    return searchStatistics(arraySize, threadCount);
+  }
+  if (argc == 2 && strcmp(argv[1], "--calibrate") == 0)
+  {
+    TuningProfile profile;
+    getTuningProfile(&profile, true);
+    printTuningProfile(&profile);
+    return 0;
+  }
+  if (argc == 2 && strcmp(argv[1], "--benchmark-completion") == 0)
+  {
+    benchmarkCompletion();
+    return 0;
+  }
+  if (argc == 4 && strcmp(argv[1], "--benchmark-monitor") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    benchmarkMonitor(arraySize, threadCount);
+    return 0;
+  }
+  if ((argc == 4 || argc == 5) && strcmp(argv[1], "--benchmark-contention") == 0)
+  {
+    size_t arraySize = parseArraySize(argv[2]);
+    size_t threadCount = parseThreadCount(argv[3]);
+    int hogCount = argc == 5 ? stoi(argv[4]) : 1;
+    if (hogCount < 0)
+    {
+      fprintf(stderr, "num_hogs must not be negative\n");
+      exit(-1);
+    }
+    benchmarkContention(arraySize, threadCount, hogCount);
+    return 0;
+  }
+  if (argc != 4 && argc != 5)
   {
-    fprintf(stderr, "num_threads must be between 1 and %d\n", MAX_THREAD_COUNT);
+    printUsage();
     exit(-1);
   }
-  int indexOfZero = stoi(argv[3]);
-  if (indexOfZero < -1 || indexOfZero >= arraySize)
+  size_t arraySize = parseArraySize(argv[1]);
+  bool autoTune = strcmp(argv[2], "auto") == 0;
+  size_t threadCount = autoTune ? 1 : parseThreadCount(argv[2]);
+  long long indexArgument = stoll(argv[3]);
+  if (indexArgument < -1 || indexArgument >= (long long) arraySize)
   {
-    fprintf(stderr, "index_of_zero must be between -1 and %d (array_size - 1)\n", arraySize - 1);
+    fprintf(stderr, "index_of_zero must be between -1 and %zu (array_size - 1)\n", arraySize - 1);
     exit(-1);
   }
-  int * data = generateInput(arraySize, indexOfZero);
-  
-  // Sequential:
-  time_t startTime = now();
-  int min = findMinSequential(data, arraySize);
-  printf("Sequential search completed in %ld ms. Min = %d\n", timeSince(startTime), min);
-  
-  // Threaded with parent waiting for all child threads:
-  ThreadInfo * threadInfo = computeThreadInfo(data, arraySize, threadCount, NULL);
-  startTime = now();
-  startAll(threadInfo, threadCount, findMinThreaded);
-  joinAll(threadInfo, threadCount);
-  min = searchThreadMinima(threadCount, threadInfo);
-  printf("Threaded search with parent waiting for all children completed in %ld ms. Min = %d\n", timeSince(startTime),
-         min);
-  free(threadInfo);
+  size_t indexOfZero = indexArgument == -1 ? NO_ZERO : (size_t) indexArgument;
+  size_t chunkSize = argc == 5 ? parseChunkSize(argv[4]) : FIND_MIN_CHUNK_SIZE;
+  // In auto mode, only the search chosen for the array is run
+  int (* autoSearch)(int const *, size_t, SharedState *, ThreadPool *) = NULL;
+  if (autoTune)
+  {
+    TuningProfile profile;
+    size_t tunedChunkSize;
+    bool pooled;
+    getTuningProfile(&profile, false);
+    bool sequential = chooseTuning(&profile, arraySize, &threadCount, &tunedChunkSize, &pooled);
+    if (argc != 5) chunkSize = tunedChunkSize;
+    autoSearch = sequential ? searchSequential : pooled ? searchOnPool : searchJoined;
+    printf("Auto-tuned for %zu elements: %s search on %zu thread(s), chunk size %zu\n", arraySize,
+           sequential ? "sequential" : pooled ? "pooled" : "spawned", threadCount, chunkSize);
+  }
+  uint64_t generateStartTime = now();
+  int * data = generateInput(arraySize, indexOfZero, threadCount);
+  double generateSeconds = (double) timeSince(generateStartTime) / 1000000000;
+  printf("Input generated in %.0f ms (%.1f M elements/s, %.2f GB/s)\n", generateSeconds * 1000,
+         arraySize / generateSeconds / 1000000, arraySize * sizeof(int) / generateSeconds / 1000000000);
   
-  // Threaded with parent busy waiting
-  threadInfo = computeThreadInfo(data, arraySize, threadCount, NULL);
-  startTime = now();
-  startAll(threadInfo, threadCount, findMinThreaded);
-  while (!allThreadsDone(threadCount, threadInfo))
+  ThreadPool * pool = createThreadPool(threadCount);
+  size_t mode;
+  for (mode = 0; mode < searchModeCount; ++mode)
   {
-    if (searchThreadMinima(threadCount, threadInfo) == 0)
+    if (autoSearch && searchModes[mode].search != autoSearch) continue;
+    SharedState sharedState = initSharedState(threadCount, chunkSize);
+    PerfCounters parentPerf;
+    if (instrument)
     {
-      cancelAll(threadInfo, threadCount);
-      break;
+      sharedState.perf = (PerfCounters *) calloc(threadCount, sizeof(PerfCounters));
+      perfBegin(&parentPerf);
+    }
+    uint64_t startTime = now();
+    int min = searchModes[mode].search(data, arraySize, &sharedState, pool);
+    uint64_t elapsed = timeSince(startTime);
+    if (instrument)
+    {
+      perfEnd(&parentPerf);
+    }
+    printf("%s completed in %.3f ms. Min = %d\n", searchModes[mode].description, (double) elapsed / 1000000, min);
+    printStopLatency(&sharedState);
+    if (instrument)
+    {
+      printPerfReport(&sharedState, &parentPerf, arraySize * sizeof(int));
+      free(sharedState.perf);
+    }
+  }
+  destroyThreadPool(pool);
+  freeInput(data, arraySize);
+  return 0;
+}
+
+/**
+ * Allocates an array of `size` integers, backed by huge pages where possible.
+ * Explicit 2 MB huge pages (`MAP_HUGETLB`) are tried first, then transparent huge pages on a 2 MB-aligned mapping,
+ * then ordinary pages. The pages are first touched by `threadCount` threads running `touch`, each over the slice of the
+ * array that `computeThreadInfo()` would give it, so that on NUMA hosts each slice is placed near the thread that
+ * searches it - reliably so when the threads are pinned with `--affinity`, as thread `i` then always runs on the same
+ * CPU.
+ * Note: should be freed with `freeInput()`.
+ * @param size The number of integers to allocate
+ * @param threadCount The number of threads that will search the array
+ * @param touch Initializes the region of the array described by the `ThreadInfo` it is passed
+ * @return The allocated array
+ */
+int * allocateInput(size_t size, size_t threadCount, void * (* touch)(void *))
+{
+  size_t bytes = (size * sizeof(int) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  void * memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (memory == MAP_FAILED)
+  {
+    // Over-allocate so a 2 MB-aligned mapping of `bytes` can be carved out, then unmap the excess on either side
+    char * raw = (char *) mmap(NULL, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                               0);
+    if (raw == (char *) MAP_FAILED)
+    {
+      perror("mmap");
+      exit(1);
+    }
+    char * aligned = (char *) (((uintptr_t) raw + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+    if (aligned > raw)
+    {
+      munmap(raw, aligned - raw);
     }
+    munmap(aligned + bytes, raw + HUGE_PAGE_SIZE - aligned);
+    memory = aligned;
+#ifdef MADV_HUGEPAGE
+    // Failure just means ordinary pages are used
+    madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
   }
+  ThreadInfo * threadInfo = computeThreadInfo((int const *) memory, size, threadCount, NULL);
+  startAll(threadInfo, threadCount, touch);
   joinAll(threadInfo, threadCount);
-  min = searchThreadMinima(threadCount, threadInfo);
-  printf("Threaded search with parent continually checking on children completed in %ld ms. Min = %d\n",
-         timeSince(startTime), min);
   free(threadInfo);
-  
-  // Threaded with parent waiting on semaphore
-  SharedState sharedState = initSharedState(threadCount);
-  threadInfo = computeThreadInfo(data, arraySize, threadCount, &sharedState);
-  startTime = now();
+  return (int *) memory;
+}
+
+/**
+ * Returns `true` if all threads are done.
+ */
+bool allThreadsDone(size_t threadCount, ThreadInfo const * threadInfo)
+{
+  size_t i;
+  for (i = 0; i < threadCount; ++i)
+  {
+    if (!__atomic_load_n(&threadInfo[i].done, __ATOMIC_ACQUIRE)) return false;
+  }
+  return true;
+}
+
+/**
+ * Arrives at `completion`, and signals it if this is the last of the arrivals it was initialized to wait for.
+ */
+void arriveAtCompletion(Completion * completion)
+{
+  if (__atomic_sub_fetch(&completion->remaining, 1, __ATOMIC_ACQ_REL) == 0)
+  {
+    signalCompletion(completion);
+  }
+}
+
+/**
+ * Runs `findMinThreaded()` for one worker of an `AsyncSearch`, and signals the search's `eventFd` if it is the last
+ * worker to finish.
+ */
+void * asyncSearchThread(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  AsyncSearch * search = (AsyncSearch *) ti->sharedState;
+  findMinThreaded(ti);
+  if (__atomic_sub_fetch(&search->running, 1, __ATOMIC_ACQ_REL) == 0)
+  {
+    uint64_t one = 1;
+    if (write(search->signalFd, &one, sizeof(one)) != sizeof(one))
+    {
+      perror("write");
+      exit(1);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Waits a little before a polling loop polls again: first by spinning on `pause` for twice as long as last time, and
+ * once `BACKOFF_SPIN_LIMIT` is reached, by yielding the CPU.
+ * @param spins The number of `pause`s spun last time - should start at 1, and is updated for the next call
+ */
+void backOff(unsigned * spins)
+{
+  if (*spins > BACKOFF_SPIN_LIMIT)
+  {
+    sched_yield();
+    return;
+  }
+  unsigned i;
+  for (i = 0; i < *spins; ++i)
+  {
+#ifdef HAVE_X86_PAUSE
+    __builtin_ia32_pause();
+#endif
+  }
+  *spins *= 2;
+}
+
+/**
+ * Runs on each worker of `runBatch()`: searches the tasks popped off the engine's queue until the end of the queue,
+ * and completes each job whose last task it searched.
+ */
+void * batchWorkerMain(void * engine)
+{
+  BatchEngine * e = (BatchEngine *) engine;
+  while (true)
+  {
+    size_t slot = popSlot(&e->queue);
+    if (slot == END_OF_STREAM) break;
+    BatchTask const * task = &e->tasks[slot];
+    BatchJob * job = task->job;
+    uint64_t startTime = 0;
+    __atomic_compare_exchange_n(&job->startTime, &startTime, now(), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    int min = findMinKernelInt32(job->data + task->begin, task->end - task->begin);
+    int jobMin = __atomic_load_n(&job->minimum, __ATOMIC_RELAXED);
+    while (min < jobMin &&
+           !__atomic_compare_exchange_n(&job->minimum, &jobMin, min, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+    if (__atomic_sub_fetch(&job->remaining, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+      job->latency = timeSince(job->submitTime);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Measures how long the parent takes to wake up once the last of `n` threads is done, for `n` from 1 to
+ * `COMPLETION_BENCHMARK_MAX_THREADS`: with a `Completion`, and with the semaphore-protected counter and semaphore the
+ * semaphore search used to wait on. The threads do no work, and all finish at once, so that any serialization of the
+ * finishing threads shows up in the latency.
+ */
+void benchmarkCompletion()
+{
+  static char const * const primitiveNames[] = {"semaphore", "completion"};
+  void * (* const arrivals[])(void *) = {timeSemaphoreArrival, timeCompletionArrival};
+  pthread_t * threads = (pthread_t *) malloc(COMPLETION_BENCHMARK_MAX_THREADS * sizeof(pthread_t));
+  if (!threads)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  uint64_t latencies[COMPLETION_BENCHMARK_REPETITIONS];
+  printf("%-12s %8s %12s %12s %12s\n", "primitive", "threads", "median (us)", "p99 (us)", "max (us)");
+  size_t threadCount;
+  for (threadCount = 1; threadCount <= COMPLETION_BENCHMARK_MAX_THREADS; threadCount *= 2)
+  {
+    size_t primitive;
+    for (primitive = 0; primitive < 2; ++primitive)
+    {
+      size_t repetition;
+      for (repetition = 0; repetition < COMPLETION_BENCHMARK_REPETITIONS; ++repetition)
+      {
+        CompletionBenchmark benchmark;
+        pthread_barrier_init(&benchmark.start, NULL, (unsigned) threadCount);
+        benchmark.lastArrivalTime = 0;
+        initCompletion(&benchmark.completion, threadCount);
+        if (sem_init(&benchmark.done, false, 0) || sem_init(&benchmark.doneCountMutex, false, 1))
+        {
+          perror("sem_init");
+          exit(1);
+        }
+        benchmark.doneCount = 0;
+        benchmark.threadCount = threadCount;
+        size_t i;
+        for (i = 0; i < threadCount; ++i)
+        {
+          if (pthread_create(&threads[i], NULL, arrivals[primitive], &benchmark))
+          {
+            perror("pthread_create");
+            exit(1);
+          }
+        }
+        if (primitive == 0)
+        {
+          while (sem_wait(&benchmark.done))
+          {
+            if (errno != EINTR)
+            {
+              perror("sem_wait");
+              exit(1);
+            }
+          }
+        }
+        else
+        {
+          waitForCompletion(&benchmark.completion);
+        }
+        uint64_t wakeTime = now();
+        latencies[repetition] = wakeTime - __atomic_load_n(&benchmark.lastArrivalTime, __ATOMIC_ACQUIRE);
+        for (i = 0; i < threadCount; ++i)
+        {
+          pthread_join(threads[i], NULL);
+        }
+        pthread_barrier_destroy(&benchmark.start);
+        sem_destroy(&benchmark.done);
+        sem_destroy(&benchmark.doneCountMutex);
+      }
+      Statistics statistics = computeStatistics(latencies, COMPLETION_BENCHMARK_REPETITIONS);
+      printf("%-12s %8zu %12.1f %12.1f %12.1f\n", primitiveNames[primitive], threadCount, statistics.median / 1000,
+             statistics.p99 / 1000, statistics.max / 1000);
+    }
+  }
+  free(threads);
+}
+
+/**
+ * Compares the latency distribution of static slicing (`findMinThreaded`) against dynamic work stealing
+ * (`findMinDynamic`) while `hogCount` CPU-bound processes compete for the cores.
+ * Both a full reduction and an early-zero-exit search are measured, with the zero placed at the end of the first
+ * thread's slice - the worst case for static slicing.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each search
+ * @param hogCount The number of background processes to start
+ */
+void benchmarkContention(size_t arraySize, size_t threadCount, size_t hogCount)
+{
+  static char const * const schedulerNames[] = {"static", "dynamic"};
+  void * (* const schedulers[])(void *) = {findMinThreaded, findMinDynamic};
+  int * data = generateInput(arraySize, arraySize / threadCount - (arraySize >= threadCount), threadCount);
+  ThreadPool * pool = createThreadPool(threadCount);
+  pid_t * hogs = (pid_t *) malloc(hogCount * sizeof(pid_t));
+  size_t i;
+  for (i = 0; i < hogCount; ++i)
+  {
+    hogs[i] = startHog();
+  }
+  uint64_t latencies[CONTENTION_BENCHMARK_REPETITIONS];
+  printf("%-10s %-20s %10s %10s %10s %10s %5s\n", "scheduler", "search", "p50 (ms)", "p99 (ms)", "max (ms)",
+         "stddev", "min");
+  int stopOnZero;
+  for (stopOnZero = 0; stopOnZero <= 1; ++stopOnZero)
+  {
+    size_t scheduler;
+    for (scheduler = 0; scheduler < 2; ++scheduler)
+    {
+      int min = 0;
+      size_t repetition;
+      for (repetition = 0; repetition < CONTENTION_BENCHMARK_REPETITIONS; ++repetition)
+      {
+        SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+        sharedState.stopOnZero = stopOnZero;
+        ThreadInfo * threadInfo = computeThreadInfo(data, arraySize, threadCount, &sharedState);
+        uint64_t startTime = now();
+        poolStartAll(pool, threadInfo, schedulers[scheduler]);
+        poolJoinAll(pool);
+        latencies[repetition] = timeSince(startTime);
+        min = searchThreadMinima(threadCount, threadInfo);
+        free(threadInfo);
+      }
+      Statistics statistics = computeStatistics(latencies, CONTENTION_BENCHMARK_REPETITIONS);
+      printf("%-10s %-20s %10.3f %10.3f %10.3f %10.3f %5d\n", schedulerNames[scheduler],
+             stopOnZero ? "early zero exit" : "full reduction", statistics.median / 1000000, statistics.p99 / 1000000,
+             statistics.max / 1000000, statistics.stddev / 1000000, min);
+    }
+  }
+  for (i = 0; i < hogCount; ++i)
+  {
+    kill(hogs[i], SIGKILL);
+    waitpid(hogs[i], NULL, 0);
+  }
+  free(hogs);
+  destroyThreadPool(pool);
+  freeInput(data, arraySize);
+}
+
+/**
+ * Measures how much a parent monitoring the threads' results slows the threads down. A full search for the minimum
+ * (no zero) is timed with the parent blocked in `pthread_join`, polling as fast as it can, and polling with
+ * `backOff()`.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each search
+ */
+void benchmarkMonitor(size_t arraySize, size_t threadCount)
+{
+  static char const * const parentNames[] = {"joining", "polling", "polling with back-off"};
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  uint64_t latencies[MONITOR_BENCHMARK_REPETITIONS];
+  printf("%-22s %12s %12s %12s %10s %5s\n", "parent", "median (ms)", "p90 (ms)", "max (ms)", "GB/s", "min");
+  size_t parent;
+  for (parent = 0; parent < 3; ++parent)
+  {
+    int min = 0;
+    size_t repetition;
+    for (repetition = 0; repetition < MONITOR_BENCHMARK_REPETITIONS; ++repetition)
+    {
+      SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+      ThreadInfo * threadInfo = computeThreadInfo(data, arraySize, threadCount, &sharedState);
+      uint64_t startTime = now();
+      startAll(threadInfo, threadCount, findMinThreaded);
+      if (parent > 0)
+      {
+        monitorThreads(threadInfo, &sharedState, parent == 2);
+      }
+      joinAll(threadInfo, threadCount);
+      latencies[repetition] = timeSince(startTime);
+      min = searchThreadMinima(threadCount, threadInfo);
+      free(threadInfo);
+    }
+    Statistics statistics = computeStatistics(latencies, MONITOR_BENCHMARK_REPETITIONS);
+    printf("%-22s %12.3f %12.3f %12.3f %10.2f %5d\n", parentNames[parent], statistics.median / 1000000,
+           statistics.p90 / 1000000, statistics.max / 1000000, arraySize * sizeof(int) / statistics.median, min);
+  }
+  freeInput(data, arraySize);
+}
+
+/**
+ * Compares the per-query latency of searching with freshly created threads (`startAll`/`joinAll`) against searching on
+ * a persistent `ThreadPool`, for array sizes from `POOL_BENCHMARK_MIN_SIZE` to `POOL_BENCHMARK_MAX_SIZE`.
+ * @param data The data to be searched - must hold at least `POOL_BENCHMARK_MAX_SIZE` elements
+ * @param threadCount The number of threads used by each query
+ */
+void benchmarkThreadPool(int const * data, size_t threadCount)
+{
+  ThreadPool * pool = createThreadPool(threadCount);
+  printf("%12s %8s %16s %16s %8s\n", "array_size", "queries", "spawn (us/query)", "pool (us/query)", "speedup");
+  size_t arraySize;
+  for (arraySize = POOL_BENCHMARK_MIN_SIZE; arraySize <= POOL_BENCHMARK_MAX_SIZE; arraySize *= 10)
+  {
+    size_t queryCount = POOL_BENCHMARK_ELEMENTS / arraySize;
+    if (queryCount > 1000) queryCount = 1000;
+    SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+    ThreadInfo * threadInfo = computeThreadInfo(data, arraySize, threadCount, &sharedState);
+    size_t query;
+    uint64_t startTime = now();
+    for (query = 0; query < queryCount; ++query)
+    {
+      startAll(threadInfo, threadCount, findMinThreaded);
+      joinAll(threadInfo, threadCount);
+    }
+    double spawnLatency = (double) timeSince(startTime) / 1000 / queryCount;
+    startTime = now();
+    for (query = 0; query < queryCount; ++query)
+    {
+      poolStartAll(pool, threadInfo, findMinThreaded);
+      poolJoinAll(pool);
+    }
+    double poolLatency = (double) timeSince(startTime) / 1000 / queryCount;
+    printf("%12zu %8zu %16.1f %16.1f %7.2fx\n", arraySize, queryCount, spawnLatency, poolLatency,
+           spawnLatency / poolLatency);
+    free(threadInfo);
+  }
+  destroyThreadPool(pool);
+}
+
+/**
+ * Microbenchmarks this host into `profile`: the bandwidth of a sequential search, the cost of spawning threads and of
+ * waking pooled ones, the chunk size that best trades scan speed against stop latency, and the bandwidth of a threaded
+ * search for each thread count up to the number of online CPUs. Takes a few seconds at most.
+ */
+void calibrateHost(TuningProfile * profile)
+{
+  long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+  profile->cpuCount = cpuCount > 0 ? (size_t) cpuCount : 1;
+  snprintf(profile->kernel, sizeof(profile->kernel), "%s", findMinKernelName());
+  fprintf(stderr, "Calibrating for num_threads auto (the results are cached)...\n");
+  int * data = generateInput(CALIBRATION_SIZE, NO_ZERO, profile->cpuCount);
+  double bytes = (double) CALIBRATION_SIZE * sizeof(int);
+  volatile int sink;
+  uint64_t best = UINT64_MAX;
+  size_t repetition;
+  for (repetition = 0; repetition < CALIBRATION_BANDWIDTH_REPETITIONS; ++repetition)
+  {
+    uint64_t startTime = now();
+    sink = findMinSequential(data, CALIBRATION_SIZE);
+    uint64_t elapsed = timeSince(startTime);
+    if (elapsed < best) best = elapsed;
+  }
+  profile->sequentialBandwidth = bytes / (best > 0 ? best : 1);
+
+  // Spawn and wake costs, on as many threads as there are CPUs and as many elements as threads
+  size_t threadCount = profile->cpuCount;
+  ThreadPool * pool = createThreadPool(threadCount);
+  uint64_t spawnSamples[CALIBRATION_LATENCY_REPETITIONS];
+  uint64_t wakeSamples[CALIBRATION_LATENCY_REPETITIONS];
+  for (repetition = 0; repetition < CALIBRATION_LATENCY_REPETITIONS; ++repetition)
+  {
+    SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+    uint64_t startTime = now();
+    sink = searchJoined(data, threadCount, &sharedState, NULL);
+    spawnSamples[repetition] = timeSince(startTime);
+    sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+    startTime = now();
+    sink = searchOnPool(data, threadCount, &sharedState, pool);
+    wakeSamples[repetition] = timeSince(startTime);
+  }
+  destroyThreadPool(pool);
+  profile->spawnCost = computeStatistics(spawnSamples, CALIBRATION_LATENCY_REPETITIONS).median / threadCount;
+  profile->wakeCost = computeStatistics(wakeSamples, CALIBRATION_LATENCY_REPETITIONS).median / threadCount;
+
+  // The smallest chunk size that nearly minimizes the time of a full search on one thread, plus the time the other
+  // threads of a search on every CPU (and at least two) take to stop once the first finds a zero at its start
+  size_t const chunkSizes[] = CALIBRATION_CHUNK_SIZES;
+  size_t const chunkSizeCount = sizeof(chunkSizes) / sizeof(chunkSizes[0]);
+  double chunkTimes[sizeof(chunkSizes) / sizeof(chunkSizes[0])];
+  double fastest = HUGE_VAL;
+  size_t stopThreadCount = profile->cpuCount > 1 ? profile->cpuCount : 2;
+  uint64_t stopSamples[CALIBRATION_BANDWIDTH_REPETITIONS];
+  size_t i;
+  for (i = 0; i < chunkSizeCount; ++i)
+  {
+    best = UINT64_MAX;
+    for (repetition = 0; repetition < CALIBRATION_BANDWIDTH_REPETITIONS; ++repetition)
+    {
+      SharedState sharedState = initSharedState(1, chunkSizes[i]);
+      uint64_t startTime = now();
+      sink = searchJoined(data, CALIBRATION_SIZE, &sharedState, NULL);
+      uint64_t elapsed = timeSince(startTime);
+      if (elapsed < best) best = elapsed;
+    }
+    data[0] = 0;
+    for (repetition = 0; repetition < CALIBRATION_BANDWIDTH_REPETITIONS; ++repetition)
+    {
+      SharedState sharedState = initSharedState(stopThreadCount, chunkSizes[i]);
+      sink = searchJoined(data, CALIBRATION_SIZE, &sharedState, NULL);
+      stopSamples[repetition] = sharedState.lastStopTime - sharedState.zeroFoundTime;
+    }
+    data[0] = randomValue(RANDOM_SEED, 0);
+    chunkTimes[i] = best + computeStatistics(stopSamples, CALIBRATION_BANDWIDTH_REPETITIONS).median;
+    if (chunkTimes[i] < fastest) fastest = chunkTimes[i];
+  }
+  for (i = 0; chunkTimes[i] > fastest * CALIBRATION_CHUNK_TOLERANCE; ++i);
+  profile->chunkSize = chunkSizes[i];
+
+  // The scaling curve
+  profile->pointCount = 0;
+  for (threadCount = 1; profile->pointCount < TUNING_MAX_POINTS; threadCount *= 2)
+  {
+    if (threadCount > profile->cpuCount) threadCount = profile->cpuCount;
+    best = UINT64_MAX;
+    for (repetition = 0; repetition < CALIBRATION_BANDWIDTH_REPETITIONS; ++repetition)
+    {
+      SharedState sharedState = initSharedState(threadCount, profile->chunkSize);
+      uint64_t startTime = now();
+      sink = searchJoined(data, CALIBRATION_SIZE, &sharedState, NULL);
+      uint64_t elapsed = timeSince(startTime);
+      if (elapsed < best) best = elapsed;
+    }
+    double searchTime = best - threadCount * profile->spawnCost;
+    profile->threadCounts[profile->pointCount] = threadCount;
+    profile->bandwidths[profile->pointCount] = bytes / (searchTime > 1 ? searchTime : 1);
+    ++profile->pointCount;
+    if (threadCount == profile->cpuCount) break;
+  }
+  (void) sink;
+  freeInput(data, CALIBRATION_SIZE);
+}
+
+/**
+ * Asks every thread sharing `sharedState` to stop searching.
+ * Threads notice the request at their next chunk boundary, and still publish the minimum of what they have searched.
+ * @param sharedState The shared state of the threads to be cancelled
+ */
+void cancelAll(SharedState * sharedState)
+{
+  __atomic_store_n(&sharedState->stop, true, __ATOMIC_RELEASE);
+}
+
+/**
+ * Asks the workers of `search` to stop at their next chunk, with `cancelAll()`. Its `eventFd` still becomes readable
+ * once they have.
+ */
+void cancelSearch(AsyncSearch * search)
+{
+  cancelAll(&search->sharedState);
+}
+
+/**
+ * Predicts from `profile` how an array of `arraySize` `int`s is searched fastest: sequentially, or on the thread count
+ * of the scaling curve whose bandwidth, net of the cost of starting its threads, is greatest. Threads are started on a
+ * `ThreadPool` if waking its workers is cheaper than spawning new threads.
+ * @param threadCount Set to the number of threads to search with (1 if sequentially)
+ * @param chunkSize Set to the chunk size to search with
+ * @param pooled Set to whether the threads should be those of a `ThreadPool` rather than new ones
+ * @return Whether a sequential search is predicted to be fastest
+ */
+bool chooseTuning(TuningProfile const * profile, size_t arraySize, size_t * threadCount, size_t * chunkSize,
+                  bool * pooled)
+{
+  double bytes = (double) arraySize * sizeof(int);
+  double bestTime = bytes / profile->sequentialBandwidth;
+  bool sequential = true;
+  *threadCount = 1;
+  *chunkSize = profile->chunkSize;
+  *pooled = profile->wakeCost < profile->spawnCost;
+  double startCost = *pooled ? profile->wakeCost : profile->spawnCost;
+  size_t i;
+  for (i = 0; i < profile->pointCount; ++i)
+  {
+    double time = bytes / profile->bandwidths[i] + profile->threadCounts[i] * startCost;
+    if (time < bestTime)
+    {
+      bestTime = time;
+      *threadCount = profile->threadCounts[i];
+      sequential = false;
+    }
+  }
+  return sequential;
+}
+
+/**
+ * `qsort` comparator for `CpuInfo`, in `PLACEMENT_COMPACT` order: by node, socket, core, then SMT sibling.
+ */
+int compareCompact(void const * a, void const * b)
+{
+  CpuInfo const * x = (CpuInfo const *) a;
+  CpuInfo const * y = (CpuInfo const *) b;
+  if (x->node != y->node) return x->node < y->node ? -1 : 1;
+  if (x->socket != y->socket) return x->socket < y->socket ? -1 : 1;
+  if (x->core != y->core) return x->core < y->core ? -1 : 1;
+  return (x->thread > y->thread) - (x->thread < y->thread);
+}
+
+/**
+ * `qsort` comparator for `CpuInfo`, in `PLACEMENT_SCATTER` order: by SMT sibling, core within its node, then node.
+ */
+int compareScatter(void const * a, void const * b)
+{
+  CpuInfo const * x = (CpuInfo const *) a;
+  CpuInfo const * y = (CpuInfo const *) b;
+  if (x->thread != y->thread) return x->thread < y->thread ? -1 : 1;
+  if (x->coreRank != y->coreRank) return x->coreRank < y->coreRank ? -1 : 1;
+  return (x->node > y->node) - (x->node < y->node);
+}
+
+/**
+ * `qsort` comparator for `uint64_t`.
+ */
+int compareUint64(void const * a, void const * b)
+{
+  uint64_t x = *(uint64_t const *) a;
+  uint64_t y = *(uint64_t const *) b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Computes summary statistics of `count` timings. Percentiles use the nearest-rank method.
+ * Note: sorts `samples` in place.
+ * @param samples The timings, in nanoseconds
+ * @param count The number of timings in `samples` - must be at least 1
+ */
+Statistics computeStatistics(uint64_t * samples, size_t count)
+{
+  qsort(samples, count, sizeof(uint64_t), compareUint64);
+  Statistics statistics;
+  statistics.min = samples[0];
+  statistics.median = samples[(count - 1) / 2];
+  statistics.p90 = samples[(count * 90 + 99) / 100 - 1];
+  statistics.p99 = samples[(count * 99 + 99) / 100 - 1];
+  statistics.max = samples[count - 1];
+  double sum = 0;
+  size_t i;
+  for (i = 0; i < count; ++i)
+  {
+    sum += samples[i];
+  }
+  statistics.mean = sum / count;
+  double squares = 0;
+  for (i = 0; i < count; ++i)
+  {
+    squares += (samples[i] - statistics.mean) * (samples[i] - statistics.mean);
+  }
+  statistics.stddev = count > 1 ? sqrt(squares / (count - 1)) : 0;
+  return statistics;
+}
+
+/**
+ * Generates a heap allocated array of `ThreadInfo` - one for each thread.
+ * @param data The data the threads will be operating on
+ * @param arraySize The size of `data`
+ * @param threadCount The number of threads (and the number of `ThreadInfo` structs to create)
+ * @return An array of size `threadCount` (heap allocated - freeing is the responsibility of the caller)
+ */
+ThreadInfo * computeThreadInfo(int const * data, size_t arraySize, size_t threadCount, SharedState * sharedState)
+{
+  ThreadInfo * threadInfo;
+  if (posix_memalign((void **) &threadInfo, CACHE_LINE_SIZE, threadCount * sizeof(ThreadInfo)))
+  {
+    perror("posix_memalign");
+    exit(1);
+  }
+  size_t i;
+  for (i = 0; i < threadCount; ++i)
+  {
+    threadInfo[i].done = false;
+    threadInfo[i].data = data;
+    threadInfo[i].minimum = INT_MAX;
+    threadInfo[i].begin_region = i * arraySize / threadCount;
+    threadInfo[i].end_region = (i + 1) * arraySize / threadCount;
+    threadInfo[i].nextIndex = threadInfo[i].begin_region;
+    threadInfo[i].sharedState = sharedState;
+  }
+  if (sharedState)
+  {
+    sharedState->threadInfo = threadInfo;
+  }
+  return threadInfo;
+}
+
+/**
+ * Creates a `ThreadPool` of `threadCount` parked threads.
+ * Note: allocates the pool dynamically - it should be freed with `destroyThreadPool()`.
+ */
+ThreadPool * createThreadPool(size_t threadCount)
+{
+  ThreadPool * pool = (ThreadPool *) malloc(sizeof(ThreadPool));
+  if (pthread_mutex_init(&pool->mutex, NULL) || pthread_cond_init(&pool->wake, NULL) ||
+      pthread_cond_init(&pool->jobDone, NULL))
+  {
+    perror("pthread_mutex_init");
+    exit(1);
+  }
+  pool->generation = 0;
+  pool->pending = 0;
+  pool->shutdown = false;
+  pool->threadInfo = NULL;
+  pool->f = NULL;
+  pool->threadCount = threadCount;
+  pool->workers = (PoolWorker *) malloc(threadCount * sizeof(PoolWorker));
+  size_t i;
+  for (i = 0; i < threadCount; ++i)
+  {
+    pool->workers[i].pool = pool;
+    pool->workers[i].index = i;
+    pthread_attr_t attr;
+    initThreadAttr(&attr, i);
+    if (pthread_create(&pool->workers[i].threadHandle, &attr, poolWorkerMain, &pool->workers[i]))
+    {
+      perror("pthread_create");
+      exit(1);
+    }
+    pthread_attr_destroy(&attr);
+  }
+  return pool;
+}
+
+/**
+ * Shuts down and joins every thread in `pool`, then frees it.
+ * Must not be called while a job is running.
+ */
+void destroyThreadPool(ThreadPool * pool)
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->shutdown = true;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+  size_t i;
+  for (i = 0; i < pool->threadCount; ++i)
+  {
+    if (pthread_join(pool->workers[i].threadHandle, NULL))
+    {
+      perror("pthread_join");
+      exit(1);
+    }
+  }
+  pthread_cond_destroy(&pool->jobDone);
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool->workers);
+  free(pool);
+}
+
+/**
+ * Reads the topology of the online CPUs this process may run on from /sys: the socket and core of each from its
+ * `topology` directory, and its NUMA node from the `cpulist` of each node. Without /sys (or on a machine without NUMA),
+ * every CPU is taken to be on node 0, and each to be a core of its own.
+ * Note: allocates `*cpus` dynamically - it should be freed.
+ * @param cpus Set to the CPUs, in ascending order of ID
+ * @return The number of CPUs
+ */
+size_t discoverTopology(CpuInfo ** cpus)
+{
+  char buffer[4096];
+  int * ids;
+  size_t idCount;
+  if (readSysFile("/sys/devices/system/cpu/online", buffer, sizeof(buffer)))
+  {
+    idCount = parseCpuList(buffer, &ids);
+  }
+  else
+  {
+    long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    snprintf(buffer, sizeof(buffer), "0-%ld", cpuCount > 0 ? cpuCount - 1 : 0);
+    idCount = parseCpuList(buffer, &ids);
+  }
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  bool haveAllowed = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+  *cpus = (CpuInfo *) malloc((idCount > 0 ? idCount : 1) * sizeof(CpuInfo));
+  if (!*cpus)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  size_t count = 0;
+  size_t i;
+  for (i = 0; i < idCount; ++i)
+  {
+    if (haveAllowed && ids[i] < CPU_SETSIZE && !CPU_ISSET(ids[i], &allowed)) continue;
+    CpuInfo * cpu = &(*cpus)[count++];
+    char path[128];
+    cpu->cpu = ids[i];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", ids[i]);
+    cpu->socket = readSysInt(path, 0);
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", ids[i]);
+    cpu->core = readSysInt(path, ids[i]);
+    cpu->node = 0;
+  }
+  free(ids);
+  if (readSysFile("/sys/devices/system/node/online", buffer, sizeof(buffer)))
+  {
+    int * nodes;
+    size_t nodeCount = parseCpuList(buffer, &nodes);
+    size_t n;
+    for (n = 0; n < nodeCount; ++n)
+    {
+      char path[128];
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", nodes[n]);
+      if (!readSysFile(path, buffer, sizeof(buffer))) continue;
+      int * nodeCpus;
+      size_t nodeCpuCount = parseCpuList(buffer, &nodeCpus);
+      size_t j;
+      for (i = 0; i < count; ++i)
+      {
+        for (j = 0; j < nodeCpuCount; ++j)
+        {
+          if (nodeCpus[j] == (*cpus)[i].cpu)
+          {
+            (*cpus)[i].node = nodes[n];
+          }
+        }
+      }
+      free(nodeCpus);
+    }
+    free(nodes);
+  }
+  // Number the SMT siblings of each core, and the cores of each node, in order of CPU ID
+  for (i = 0; i < count; ++i)
+  {
+    CpuInfo * cpu = &(*cpus)[i];
+    cpu->thread = 0;
+    cpu->coreRank = 0;
+    size_t j;
+    for (j = 0; j < count; ++j)
+    {
+      CpuInfo const * other = &(*cpus)[j];
+      if (other->socket == cpu->socket && other->core == cpu->core && other->cpu < cpu->cpu)
+      {
+        ++cpu->thread;
+      }
+    }
+  }
+  for (i = 0; i < count; ++i)
+  {
+    CpuInfo * cpu = &(*cpus)[i];
+    size_t j;
+    for (j = 0; j < count; ++j)
+    {
+      CpuInfo const * other = &(*cpus)[j];
+      if (other->thread == 0 && other->node == cpu->node &&
+          (other->socket < cpu->socket || (other->socket == cpu->socket && other->core < cpu->core)))
+      {
+        ++cpu->coreRank;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * Fetches the result of `search` without blocking, if it is done: stores its minimum (that of the part searched, if
+ * it was cancelled) in `minimum`, frees the search and returns `true`. Returns `false`, leaving `search` alone, if it
+ * is still running.
+ */
+bool fetchSearchResult(AsyncSearch * search, int * minimum)
+{
+  if (!pollSearch(search)) return false;
+  size_t threadCount = search->sharedState.threadCount;
+  joinAll(search->threadInfo, threadCount);
+  *minimum = searchThreadMinima(threadCount, search->threadInfo);
+  close(search->eventFd);
+  if (search->signalFd != search->eventFd)
+  {
+    close(search->signalFd);
+  }
+  free(search->threadInfo);
+  free(search);
+  return true;
+}
+
+/**
+ * Fills `data` with uniform values, and places `BOUNDARY_ZERO_CLUSTER` zeros on each side of every boundary between the
+ * slices that `computeThreadInfo()` gives `threadCount` threads. Every thread but the first finds a zero at once, and
+ * the first only at the end of its slice.
+ */
+void fillBoundaryZeros(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  fillNoZero(data, size, seed, threadCount);
+  size_t thread;
+  for (thread = 1; thread < threadCount; ++thread)
+  {
+    size_t boundary = thread * size / threadCount;
+    size_t begin = boundary > BOUNDARY_ZERO_CLUSTER ? boundary - BOUNDARY_ZERO_CLUSTER : 0;
+    size_t end = boundary + BOUNDARY_ZERO_CLUSTER < size ? boundary + BOUNDARY_ZERO_CLUSTER : size;
+    size_t i;
+    for (i = begin; i < end; ++i)
+    {
+      data[i] = 0;
+    }
+  }
+}
+
+/**
+ * Fills `data` with values between 1 and 4, so that the minimum occurs throughout it, and no zero stops the search.
+ */
+void fillDuplicates(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  size_t i;
+  for (i = 0; i < size; ++i)
+  {
+    data[i] = (int) (randomBits(seed, i) >> 62) + 1;
+  }
+  (void) threadCount;
+}
+
+/**
+ * Fills `data` with uniform values, with a single zero at its last element - the last one the last thread searches.
+ */
+void fillLastZero(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  fillNoZero(data, size, seed, threadCount);
+  if (size > 0)
+  {
+    data[size - 1] = 0;
+  }
+}
+
+/**
+ * Fills `data` with `randomValue(seed, i)` at each index `i`: uniform values between 1 and `MAX_RANDOM_NUMBER`.
+ */
+void fillNoZero(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  size_t i;
+  for (i = 0; i < size; ++i)
+  {
+    data[i] = randomValue(seed, i);
+  }
+  (void) threadCount;
+}
+
+/**
+ * Fills `data` with values descending from `MAX_RANDOM_NUMBER` to a zero at its last element.
+ */
+void fillReverseSorted(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  size_t i;
+  for (i = 0; i < size; ++i)
+  {
+    data[i] = (int) ((uint64_t) (size - 1 - i) * (MAX_RANDOM_NUMBER + 1) / size);
+  }
+  (void) seed;
+  (void) threadCount;
+}
+
+/**
+ * Fills `data` with values ascending from a zero at its first element to `MAX_RANDOM_NUMBER`.
+ */
+void fillSorted(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  size_t i;
+  for (i = 0; i < size; ++i)
+  {
+    data[i] = (int) ((uint64_t) i * (MAX_RANDOM_NUMBER + 1) / size);
+  }
+  (void) seed;
+  (void) threadCount;
+}
+
+/**
+ * Fills `data` with uniform values, with a single zero at an index chosen by `seed`.
+ */
+void fillUniformZero(int * data, size_t size, uint64_t seed, size_t threadCount)
+{
+  fillNoZero(data, size, seed, threadCount);
+  if (size > 0)
+  {
+    data[randomBits(seed, size) % size] = 0;
+  }
+}
+
+/**
+ * Find the minimum value in `data`. Multi threaded, with chunks of `sharedState->chunkSize` elements claimed
+ * dynamically.
+ * Each thread claims chunks from the front of its own region, then steals chunks from the other threads' regions once
+ * its own is exhausted, so a slow thread's unsearched chunks are picked up by the others.
+ * Stops early at a chunk boundary if a zero is found and `sharedState->stopOnZero` is set, or the search is cancelled.
+ * @param threadInfo The `ThreadInfo` of this thread - its `sharedState` must not be `NULL`
+ */
+void * findMinDynamic(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  SharedState * sharedState = ti->sharedState;
+  size_t self = ti - sharedState->threadInfo;
+  perfBeginThread(ti);
+  int min = INT_MAX;
+  size_t i;
+  for (i = 0; i < sharedState->threadCount; ++i)
+  {
+    ThreadInfo * victim = &sharedState->threadInfo[(self + i) % sharedState->threadCount];
+    while (!__atomic_load_n(&sharedState->stop, __ATOMIC_RELAXED))
+    {
+      size_t begin = __atomic_fetch_add(&victim->nextIndex, sharedState->chunkSize, __ATOMIC_RELAXED);
+      if (begin >= victim->end_region) break;
+      size_t end = victim->end_region - begin < sharedState->chunkSize ? victim->end_region
+                                                                        : begin + sharedState->chunkSize;
+      int chunkMin = findMinInChunk(ti->data + begin, end - begin, sharedState->stopOnZero);
+      if (chunkMin < min)
+      {
+        min = chunkMin;
+      }
+      if (min == 0)
+      {
+        reportZero(sharedState);
+      }
+    }
+  }
+  __atomic_store_n(&ti->minimum, min, __ATOMIC_RELEASE);
+  reportStopped(sharedState);
+  perfEndThread(ti);
+  __atomic_store_n(&ti->done, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+/**
+ * Finds the minimum of the `size` elements at `data` with the FindMin library's `int32_t` kernel.
+ * @param stopOnZero If `true`, the kernel may return as soon as it finds a zero
+ */
+int findMinInChunk(int const * data, size_t size, bool stopOnZero)
+{
+  return stopOnZero ? findMinKernelUntilInt32(data, size, 0) : findMinKernelInt32(data, size);
+}
+
+/**
+ * Find the minimum value in the given region of `data`
+ * The region to be searched is specified by `[begin, end)`.
+ * The region is handed to `findMinInChunk` in chunks of `sharedState->chunkSize` elements, and the search stops early
+ * at a chunk boundary if `sharedState->stop` has been set.
+ * @param data The data to be searched
+ * @param begin The index of the beginning of the region to search (inclusive)
+ * @param end The index of the end of the region to search (exclusive)
+ * @param sharedState The state shared with the other searching threads, or `NULL` if searching alone
+ * @return The minimum value in the region `[begin, end)` of `data`, or in the part of it searched before stopping
+ */
+int findMinInRegion(int const * data, size_t begin, size_t end, SharedState * sharedState)
+{
+  size_t chunkSize = sharedState ? sharedState->chunkSize : FIND_MIN_CHUNK_SIZE;
+  bool stopOnZero = !sharedState || sharedState->stopOnZero;
+  int min = INT_MAX;
+  size_t i;
+  for (i = begin; i < end; i += chunkSize)
+  {
+    if (sharedState && __atomic_load_n(&sharedState->stop, __ATOMIC_RELAXED)) break;
+    int chunkMin = findMinInChunk(data + i, end - i < chunkSize ? end - i : chunkSize, stopOnZero);
+    if (chunkMin == 0 && stopOnZero) return 0;
+    if (chunkMin < min)
+    {
+      min = chunkMin;
+    }
+  }
+  return min;
+}
+
+/**
+ * Returns the minimum of a `PackedInput`, searched with the library kernel for its width.
+ */
+int findMinPacked(PackedInput const * packed, FindMinOptions const * options)
+{
+  switch (packed->width)
+  {
+  case sizeof(uint8_t):
+    return packed->base + findMinUint8((uint8_t const *) packed->values, packed->size, options);
+  case sizeof(uint16_t):
+    return packed->base + findMinUint16((uint16_t const *) packed->values, packed->size, options);
+  default:
+    return packed->base + findMinInt32((int32_t const *) packed->values, packed->size, options);
+  }
+}
+
+/**
+ * Find the minimum value in `data`. Single threaded.
+ * @param data The data to be searched
+ * @param size The size of `data`
+ * @return The minimum value in `data`
+ */
+int findMinSequential(int const * const data, size_t size)
+{
+  return findMinInRegion(data, 0, size, NULL);
+}
+
+/**
+ * Find the minimum value in `data`. Multi threaded.
+ * If this thread finds a zero, every other thread sharing its `SharedState` stops at its next chunk boundary.
+ * @param region The region of `data` to search
+ * @return The minimum value in the specified region of `data`
+ */
+void * findMinThreaded(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  perfBeginThread(ti);
+  int min = findMinInRegion(ti->data, ti->begin_region, ti->end_region, ti->sharedState);
+  __atomic_store_n(&ti->minimum, min, __ATOMIC_RELEASE);
+  if (min == 0)
+  {
+    reportZero(ti->sharedState);
+  }
+  reportStopped(ti->sharedState);
+  perfEndThread(ti);
+  __atomic_store_n(&ti->done, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+/**
+ * Runs `findMinThreaded()`, then waits at the search's barrier for the other workers and the parent.
+ */
+void * findMinThreadedWithBarrier(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  findMinThreaded(ti);
+  pthread_barrier_wait(&ti->sharedState->channel->barrier);
+  return NULL;
+}
+
+/**
+ * Runs `findMinThreaded()`, then wakes the parent through the search's condition variable if this is the last worker
+ * to finish, or it found a zero.
+ */
+void * findMinThreadedWithCondition(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  findMinThreaded(ti);
+  WakeChannel * channel = ti->sharedState->channel;
+  pthread_mutex_lock(&channel->mutex);
+  if (--channel->remaining == 0 || ti->minimum == 0)
+  {
+    channel->signalled = true;
+    pthread_cond_signal(&channel->changed);
+  }
+  pthread_mutex_unlock(&channel->mutex);
+  return NULL;
+}
+
+/**
+ * Runs `findMinThreaded()`, then adds to the search's eventfd: 1, or the whole thread count if it found a zero, so
+ * that the parent stops waiting at once.
+ */
+void * findMinThreadedWithEventFd(void * threadInfo)
+{
+#ifdef __linux__
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  findMinThreaded(ti);
+  uint64_t count = ti->minimum == 0 ? ti->sharedState->threadCount : 1;
+  while (write(ti->sharedState->channel->eventFd, &count, sizeof(count)) != sizeof(count))
+  {
+    if (errno != EINTR)
+    {
+      perror("write");
+      exit(1);
+    }
+  }
+  return NULL;
+#else
+  return findMinThreadedWithCondition(threadInfo);
+#endif
+}
+
+void * findMinThreadedWithSemaphore(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  perfBeginThread(ti);
+  int min = findMinInRegion(ti->data, ti->begin_region, ti->end_region, ti->sharedState);
+  __atomic_store_n(&ti->minimum, min, __ATOMIC_RELEASE);
+  if (min == 0)
+  {
+    reportZero(ti->sharedState);
+  }
+  reportStopped(ti->sharedState);
+  perfEndThread(ti);
+  __atomic_store_n(&ti->done, true, __ATOMIC_RELEASE);
+  if (min == 0)
+  {
+    signalCompletion(&ti->sharedState->searchDone);
+  }
+  else
+  {
+    arriveAtCompletion(&ti->sharedState->searchDone);
+  }
+  return NULL;
+}
+
+/**
+ * Frees an array allocated by `allocateInput()` or `generateInput()`.
+ * @param data The array to free
+ * @param size The number of integers in `data`
+ */
+void freeInput(int * data, size_t size)
+{
+  size_t bytes = (size * sizeof(int) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (munmap(data, bytes))
+  {
+    perror("munmap");
+  }
+}
+
+/**
+ * Frees the elements of a `PackedInput` filled in by `packInput()`.
+ */
+void freePackedInput(PackedInput * packed)
+{
+  free(packed->values);
+  packed->values = NULL;
+}
+
+/**
+ * Destroys a `SlotQueue` initialized with `initSlotQueue()`.
+ */
+void freeSlotQueue(SlotQueue * queue)
+{
+  pthread_mutex_destroy(&queue->mutex);
+  if (sem_destroy(&queue->items))
+  {
+    perror("sem_destroy");
+  }
+  free(queue->slots);
+}
+
+/**
+ * Creates an array of integers between 1 and `MAX_RANDOM_NUMBER`.
+ * Places a single `0` at `indexOfZero`.
+ * The array is filled in parallel by `threadCount` threads, but its contents depend only on `RANDOM_SEED` - not on the
+ * number of threads.
+ * Note: allocates the array with `allocateInput()` - it should be freed with `freeInput()`.
+ * @param size The size of the array created
+ * @param indexOfZero The index at which to place a `0`. If `NO_ZERO`, no zero is placed.
+ * @param threadCount The number of threads that will search the array
+ * @returns The created array
+ */
+int * generateInput(size_t size, size_t indexOfZero, size_t threadCount)
+{
+  if (indexOfZero != NO_ZERO && indexOfZero >= size) return NULL;
+  int * array = allocateInput(size, threadCount, generateRegion);
+  if (indexOfZero != NO_ZERO)
+  {
+    array[indexOfZero] = 0;
+  }
+  return array;
+}
+
+/**
+ * Fills the region of the array described by `threadInfo` with `randomValue(RANDOM_SEED, index)` for each index.
+ */
+void * generateRegion(void * threadInfo)
+{
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  int * data = (int *) ti->data;
+  size_t i;
+  for (i = ti->begin_region; i < ti->end_region; ++i)
+  {
+    data[i] = randomValue(RANDOM_SEED, i);
+  }
+  return NULL;
+}
+
+/**
+ * Creates an array of `size` integers shaped like `scenario`, for `seed` and a search on `threadCount` threads.
+ * Note: allocates the array with `allocateInput()` - it should be freed with `freeInput()`.
+ * @return The created array
+ */
+int * generateScenario(Scenario const * scenario, size_t size, uint64_t seed, size_t threadCount)
+{
+  int * data = allocateInput(size, threadCount, touchRegion);
+  scenario->fill(data, size, seed, threadCount);
+  return data;
+}
+
+/**
+ * Loads this host's tuning profile from the file named by `tuningProfilePath()`, or - on the first run, if
+ * `recalibrate` is set, or if the cached profile no longer matches the host - measures it with `calibrateHost()` and
+ * saves it there. Failing to save it is reported, but not fatal.
+ */
+void getTuningProfile(TuningProfile * profile, bool recalibrate)
+{
+  char path[PATH_MAX];
+  bool havePath = tuningProfilePath(path, sizeof(path));
+  long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+  if (!recalibrate && havePath && loadTuningProfile(profile, path) && (long) profile->cpuCount == cpuCount &&
+      strcmp(profile->kernel, findMinKernelName()) == 0)
+  {
+    return;
+  }
+  calibrateHost(profile);
+  if (!havePath)
+  {
+    fprintf(stderr, "Neither MTFINDMIN_PROFILE, XDG_CACHE_HOME nor HOME is set; the tuning profile is not saved\n");
+  }
+  else if (saveTuningProfile(profile, path))
+  {
+    fprintf(stderr, "Saved the tuning profile to %s\n", path);
+  }
+}
+
+/**
+ * Initializes `completion` to be signalled once `count` threads have arrived at it (immediately, if `count` is 0).
+ */
+void initCompletion(Completion * completion, size_t count)
+{
+  completion->remaining = count;
+  completion->state = count == 0 ? COMPLETION_SIGNALLED : COMPLETION_PENDING;
+}
+
+SharedState initSharedState(size_t threadCount, size_t chunkSize)
+{
+  SharedState sharedState;
+  initCompletion(&sharedState.searchDone, threadCount);
+  sharedState.threadCount = threadCount;
+  sharedState.chunkSize = chunkSize;
+  sharedState.stop = false;
+  sharedState.zeroFoundTime = 0;
+  sharedState.lastStopTime = 0;
+  sharedState.observedTime = 0;
+  sharedState.stopOnZero = true;
+  sharedState.channel = NULL;
+  sharedState.threadInfo = NULL;
+  sharedState.perf = NULL;
+  return sharedState;
+}
+
+/**
+ * Initializes an empty `SlotQueue` that can hold up to `capacity` slots.
+ */
+void initSlotQueue(SlotQueue * queue, size_t capacity)
+{
+  if (pthread_mutex_init(&queue->mutex, NULL))
+  {
+    perror("pthread_mutex_init");
+    exit(1);
+  }
+  if (sem_init(&queue->items, false, 0))
+  {
+    perror("sem_init");
+    exit(1);
+  }
+  queue->slots = (size_t *) malloc(capacity * sizeof(size_t));
+  if (!queue->slots)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  queue->capacity = capacity;
+  queue->head = 0;
+  queue->tail = 0;
+}
+
+/**
+ * Initializes `attr` for creating the `index`th thread of a group, pinned to its CPU in `threadCpus` if threads are
+ * being pinned. The affinity is set before the thread starts, so that the pages it first touches are placed on its
+ * node. Failing to set it is reported, but not fatal.
+ * Note: `attr` should be destroyed with `pthread_attr_destroy()`.
+ */
+void initThreadAttr(pthread_attr_t * attr, size_t index)
+{
+  if (pthread_attr_init(attr))
+  {
+    perror("pthread_attr_init");
+    exit(1);
+  }
+#ifdef __linux__
+  if (threadCpuCount > 0)
+  {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(threadCpus[index % threadCpuCount], &cpus);
+    int error = pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus);
+    if (error)
+    {
+      fprintf(stderr, "pthread_attr_setaffinity_np: %s\n", strerror(error));
+    }
+  }
+#else
+  (void) index;
+#endif
+}
+
+/**
+ * Calls `pthread_join` on every thread in `threads`.
+ * @param threads The threads to be joined
+ * @param threadCount The number of threads in `threads`
+ */
+void joinAll(ThreadInfo const * threadInfo, size_t threadCount)
+{
+  size_t i;
+  for (i = 0; i < threadCount; ++i)
+  {
+    if (pthread_join(threadInfo[i].threadHandle, NULL))
+    {
+      perror("pthread_join");
+      exit(1);
+    }
+  }
+}
+
+/**
+ * Reads a regression baseline written by `runRegression()`: a CSV file with a header line, then one line of
+ * `scenario,array_size,threads,mode,median_gbps` per case.
+ * Note: allocates `*entries` dynamically - it should be freed.
+ * @param entries Set to the cases read
+ * @return The number of cases
+ */
+size_t loadBaseline(char const * path, BaselineEntry ** entries)
+{
+  FILE * file = fopen(path, "r");
+  if (!file)
+  {
+    perror(path);
+    exit(1);
+  }
+  size_t count = 0;
+  size_t capacity = 64;
+  *entries = (BaselineEntry *) malloc(capacity * sizeof(BaselineEntry));
+  if (!*entries)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), file))
+  {
+    if (count == capacity)
+    {
+      capacity *= 2;
+      *entries = (BaselineEntry *) realloc(*entries, capacity * sizeof(BaselineEntry));
+      if (!*entries)
+      {
+        perror("realloc");
+        exit(1);
+      }
+    }
+    BaselineEntry * entry = &(*entries)[count];
+    if (sscanf(line, "%31[^,],%zu,%zu,%31[^,],%lf", entry->scenario, &entry->size, &entry->threadCount, entry->mode,
+               &entry->gigabytesPerSecond) == 5)
+    {
+      ++count;
+    }
+  }
+  fclose(file);
+  return count;
+}
+
+/**
+ * Reads a tuning profile written by `saveTuningProfile()`.
+ * @return `false` if the file could not be read, or is not a profile of the current version
+ */
+bool loadTuningProfile(TuningProfile * profile, char const * path)
+{
+  FILE * file = fopen(path, "r");
+  if (!file) return false;
+  int version;
+  bool valid = fscanf(file, "mtfindmin-profile %d\n", &version) == 1 && version == TUNING_PROFILE_VERSION &&
+               fscanf(file, "cpus %zu\nkernel %15s\nsequential_bandwidth %lf\nspawn_cost %lf\nwake_cost %lf\n"
+                      "chunk_size %zu\npoints %zu\n", &profile->cpuCount, profile->kernel,
+                      &profile->sequentialBandwidth, &profile->spawnCost, &profile->wakeCost, &profile->chunkSize,
+                      &profile->pointCount) == 7 &&
+               profile->pointCount > 0 && profile->pointCount <= TUNING_MAX_POINTS && profile->chunkSize > 0 &&
+               profile->sequentialBandwidth > 0;
+  size_t i;
+  for (i = 0; valid && i < profile->pointCount; ++i)
+  {
+    valid = fscanf(file, "%zu %lf\n", &profile->threadCounts[i], &profile->bandwidths[i]) == 2 &&
+            profile->bandwidths[i] > 0;
+  }
+  fclose(file);
+  return valid;
+}
+
+/**
+ * Maps a file of binary `int`s read-only, hinting to the kernel that it will be read sequentially, soon, and (where
+ * the file system supports it) that it may be backed by huge pages.
+ * Exits with an error if the file cannot be mapped or holds no complete `int`. Trailing bytes that do not form a
+ * complete `int` are ignored.
+ * Note: the mapping should be released with `munmap()` over `*size * sizeof(int)` bytes.
+ * @param path The file to map
+ * @param size Set to the number of `int`s in the file
+ * @param dropCache If `true`, the file's pages are first evicted from the page cache so the search starts cold
+ * @return The mapped file
+ */
+int const * mapInputFile(char const * path, size_t * size, bool dropCache)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    perror(path);
+    exit(1);
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat))
+  {
+    perror("fstat");
+    exit(1);
+  }
+  *size = fileStat.st_size / sizeof(int);
+  if (*size == 0)
+  {
+    fprintf(stderr, "%s does not contain any integers\n", path);
+    exit(1);
+  }
+  if (fileStat.st_size % sizeof(int))
+  {
+    fprintf(stderr, "Ignoring the last %zu bytes of %s\n", (size_t) (fileStat.st_size % sizeof(int)), path);
+  }
+  if (dropCache)
+  {
+    // Only clean pages are dropped, which is all of them for a file that is not being written
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  }
+  void * mapping = mmap(NULL, *size * sizeof(int), PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED)
+  {
+    perror("mmap");
+    exit(1);
+  }
+  close(fd);
+  // The hints are advisory, so failures (e.g. no huge page support for this file system) are ignored
+  madvise(mapping, *size * sizeof(int), MADV_SEQUENTIAL);
+  madvise(mapping, *size * sizeof(int), MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+  madvise(mapping, *size * sizeof(int), MADV_HUGEPAGE);
+#endif
+  return (int const *) mapping;
+}
+
+/**
+ * Adds every counter that is available in `part` to `total`.
+ */
+void mergePerfCounters(PerfCounters * total, PerfCounters const * part)
+{
+  size_t i;
+  for (i = 0; i < PERF_COUNTER_COUNT; ++i)
+  {
+    if (part->available[i])
+    {
+      total->values[i] += part->values[i];
+      total->available[i] = true;
+    }
+  }
+}
+
+/**
+ * Polls the threads' result slots until every thread is done, or cancels the search as soon as one of them has found
+ * a zero.
+ * @param threadInfo The threads to monitor - `sharedState->threadCount` of them
+ * @param sharedState The state shared by the threads
+ * @param useBackOff If `true`, waits with `backOff()` between polls; otherwise polls continuously
+ */
+void monitorThreads(ThreadInfo * threadInfo, SharedState * sharedState, bool useBackOff)
+{
+  unsigned spins = 1;
+  while (!allThreadsDone(sharedState->threadCount, threadInfo))
+  {
+    if (searchThreadMinima(sharedState->threadCount, threadInfo) == 0)
+    {
+      cancelAll(sharedState);
+      break;
+    }
+    if (useBackOff)
+    {
+      backOff(&spins);
+    }
+  }
+}
+
+/**
+ * Returns the current time in nanoseconds, from a monotonic clock.
+ */
+uint64_t now()
+{
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return (uint64_t) time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+/**
+ * Stores the `size` elements of `data`, all of which must be in `[lowest, highest]`, in `packed` - as `uint8_t`s or
+ * `uint16_t`s if the range fits, shifted down by `lowest` only if that makes it fit in fewer bytes.
+ */
+void packInput(PackedInput * packed, int const * data, size_t size, int lowest, int highest)
+{
+  long long unshiftedRange = (long long) highest - (lowest < 0 ? lowest : 0);
+  long long shiftedRange = (long long) highest - lowest;
+  size_t unshiftedWidth = unshiftedRange <= UINT8_MAX ? 1 : unshiftedRange <= UINT16_MAX ? 2 : sizeof(int);
+  size_t shiftedWidth = shiftedRange <= UINT8_MAX ? 1 : shiftedRange <= UINT16_MAX ? 2 : sizeof(int);
+  packed->width = shiftedWidth < unshiftedWidth ? shiftedWidth : unshiftedWidth;
+  packed->base = packed->width == sizeof(int) ? 0 : shiftedWidth < unshiftedWidth || lowest < 0 ? lowest : 0;
+  packed->size = size;
+  if (posix_memalign(&packed->values, CACHE_LINE_SIZE, size * packed->width + (size == 0)))
+  {
+    perror("posix_memalign");
+    exit(1);
+  }
+  size_t i;
+  switch (packed->width)
+  {
+  case sizeof(uint8_t):
+    for (i = 0; i < size; ++i)
+    {
+      ((uint8_t *) packed->values)[i] = (uint8_t) (data[i] - packed->base);
+    }
+    break;
+  case sizeof(uint16_t):
+    for (i = 0; i < size; ++i)
+    {
+      ((uint16_t *) packed->values)[i] = (uint16_t) (data[i] - packed->base);
+    }
+    break;
+  default:
+    memcpy(packed->values, data, size * sizeof(int));
+  }
+}
+
+/**
+ * Parses an `array_size` argument, exiting with an error if it is not a positive number.
+ */
+size_t parseArraySize(char const * str)
+{
+  long long arraySize = stoll(str);
+  if (arraySize <= 0)
+  {
+    fprintf(stderr, "array_size must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) arraySize;
+}
+
+/**
+ * Parses a `block_size` argument, exiting with an error if it is not a positive number.
+ */
+size_t parseBlockSize(char const * str)
+{
+  long long blockSize = stoll(str);
+  if (blockSize < 1)
+  {
+    fprintf(stderr, "block_size must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) blockSize;
+}
+
+/**
+ * Parses a `buffer_count` argument, exiting with an error if it is not a positive number.
+ */
+size_t parseBufferCount(char const * str)
+{
+  long long bufferCount = stoll(str);
+  if (bufferCount < 1)
+  {
+    fprintf(stderr, "buffer_count must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) bufferCount;
+}
+
+/**
+ * Parses a `chunk_size` argument, exiting with an error if it is not a positive number.
+ */
+size_t parseChunkSize(char const * str)
+{
+  long long chunkSize = stoll(str);
+  if (chunkSize < 1)
+  {
+    fprintf(stderr, "chunk_size must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) chunkSize;
+}
+
+/**
+ * Parses a list of CPU (or node) IDs in the format of /sys, such as `0-3,8,10-11`.
+ * Note: allocates `*cpus` dynamically - it should be freed.
+ * @param cpus Set to the IDs in the list
+ * @return The number of IDs, or 0 if the list is malformed
+ */
+size_t parseCpuList(char const * str, int ** cpus)
+{
+  size_t count = 0;
+  size_t capacity = 16;
+  *cpus = (int *) malloc(capacity * sizeof(int));
+  if (!*cpus)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  while (*str && *str != '\n')
+  {
+    char * end;
+    long first = strtol(str, &end, 10);
+    long last = first;
+    if (end == str || first < 0) return 0;
+    if (*end == '-')
+    {
+      str = end + 1;
+      last = strtol(str, &end, 10);
+      if (end == str || last < first) return 0;
+    }
+    long id;
+    for (id = first; id <= last; ++id)
+    {
+      if (count == capacity)
+      {
+        capacity *= 2;
+        *cpus = (int *) realloc(*cpus, capacity * sizeof(int));
+        if (!*cpus)
+        {
+          perror("realloc");
+          exit(1);
+        }
+      }
+      (*cpus)[count++] = (int) id;
+    }
+    str = *end == ',' ? end + 1 : end;
+  }
+  return count;
+}
+
+/**
+ * Parses a comma-separated list, using `parse` for each item.
+ * Note: allocates `*values` dynamically - freeing is the responsibility of the caller.
+ * @param str The list to parse
+ * @param values Set to the parsed items
+ * @param parse Parses one item, exiting with an error if it is invalid
+ * @return The number of items in `*values`
+ */
+size_t parseList(char const * str, size_t ** values, size_t (* parse)(char const *))
+{
+  size_t count = 1;
+  char const * c;
+  for (c = str; *c; ++c)
+  {
+    count += *c == ',';
+  }
+  *values = (size_t *) malloc(count * sizeof(size_t));
+  if (!*values)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  char * copy = strdup(str);
+  if (!copy)
+  {
+    perror("strdup");
+    exit(1);
+  }
+  char * savePointer;
+  char * item = strtok_r(copy, ",", &savePointer);
+  count = 0;
+  while (item)
+  {
+    (*values)[count++] = parse(item);
+    item = strtok_r(NULL, ",", &savePointer);
+  }
+  free(copy);
+  if (count == 0)
+  {
+    fprintf(stderr, "%s is an empty list\n", str);
+    exit(-1);
+  }
+  return count;
+}
+
+/**
+ * Parses the `query_count` argument of `--ranges`, exiting with an error if it is not a positive number.
+ */
+size_t parseQueryCount(char const * str)
+{
+  long long queryCount = stoll(str);
+  if (queryCount < 1)
+  {
+    fprintf(stderr, "query_count must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) queryCount;
+}
+
+/**
+ * Parses the `--repetitions` option of `--benchmark` and `--regress`, exiting with an error if it is not a positive
+ * number.
+ */
+size_t parseRepetitions(char const * str)
+{
+  long long repetitions = stoll(str);
+  if (repetitions < 1)
+  {
+    fprintf(stderr, "repetitions must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) repetitions;
+}
+
+/**
+ * Parses the `search_count` argument of `--async`, exiting with an error if it is not a positive number.
+ */
+size_t parseSearchCount(char const * str)
+{
+  long long searchCount = stoll(str);
+  if (searchCount < 1)
+  {
+    fprintf(stderr, "search_count must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) searchCount;
+}
+
+/**
+ * Parses the `--seed` option of `--regress`, exiting with an error if it is negative.
+ */
+uint64_t parseSeed(char const * str)
+{
+  long long seed = stoll(str);
+  if (seed < 0)
+  {
+    fprintf(stderr, "seed must be at least 0\n");
+    exit(-1);
+  }
+  return (uint64_t) seed;
+}
+
+/**
+ * Parses a comma-separated list of names for `runBenchmark()` and `runRegression()`, exiting with an error if one is
+ * not the name of any of the `itemCount` items of `itemSize` bytes in `items`, each of which starts with its name.
+ * Note: the returned array should be freed.
+ * @param str The list, or `NULL` to select every item
+ * @param kind What an item is, for the error message
+ * @return An array of `itemCount` flags, set for each item that is named in `str`
+ */
+bool * parseSelection(char const * str, void const * items, size_t itemCount, size_t itemSize, char const * kind)
+{
+  bool * selected = (bool *) malloc(itemCount * sizeof(bool));
+  if (!selected)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  size_t item;
+  for (item = 0; item < itemCount; ++item)
+  {
+    selected[item] = !str;
+  }
+  if (str)
+  {
+    char * copy = strdup(str);
+    if (!copy)
+    {
+      perror("strdup");
+      exit(1);
+    }
+    char * savePointer;
+    char * name;
+    for (name = strtok_r(copy, ",", &savePointer); name; name = strtok_r(NULL, ",", &savePointer))
+    {
+      for (item = 0; item < itemCount; ++item)
+      {
+        // Each item starts with its name
+        if (strcmp(name, *(char const * const *) ((char const *) items + item * itemSize)) == 0)
+        {
+          break;
+        }
+      }
+      if (item == itemCount)
+      {
+        fprintf(stderr, "%s is not a %s\n", name, kind);
+        exit(-1);
+      }
+      selected[item] = true;
+    }
+    free(copy);
+  }
+  return selected;
+}
+
+/**
+ * Parses the `k` argument of `--smallest`, exiting with an error if it is not a positive number.
+ */
+size_t parseSmallestCount(char const * str)
+{
+  long long k = stoll(str);
+  if (k < 1)
+  {
+    fprintf(stderr, "k must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) k;
+}
+
+/**
+ * Parses a `num_threads` argument, exiting with an error if it is negative or greater than `MAX_THREAD_COUNT`.
+ * 0 stands for one thread per online CPU.
+ */
+size_t parseThreadCount(char const * str)
+{
+  long long threadCount = stoll(str);
+  if (threadCount < 0)
+  {
+    fprintf(stderr, "num_threads must not be negative\n");
+    exit(-1);
+  }
+  if (threadCount > MAX_THREAD_COUNT)
+  {
+    fprintf(stderr, "num_threads must be at most %d\n", MAX_THREAD_COUNT);
+    exit(-1);
+  }
+  if (threadCount == 0)
+  {
+    long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpuCount > 0 ? (size_t) cpuCount : 1;
+  }
+  return (size_t) threadCount;
+}
+
+/**
+ * Parses the `--threshold` option of `--regress`, a percentage, exiting with an error if it is not a number of at least
+ * 0.
+ */
+double parseThreshold(char const * str)
+{
+  char * end;
+  errno = 0;
+  double threshold = strtod(str, &end);
+  if (end == str || *end != '\0' || errno == ERANGE || !(threshold >= 0))
+  {
+    fprintf(stderr, "threshold must be a number of at least 0\n");
+    exit(-1);
+  }
+  return threshold;
+}
+
+/**
+ * Returns whether every worker of `search` is done, without blocking.
+ */
+bool pollSearch(AsyncSearch const * search)
+{
+  return __atomic_load_n(&search->running, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * Removes and returns the slot at the front of `queue`, waiting for one to be pushed if it is empty.
+ */
+size_t popSlot(SlotQueue * queue)
+{
+  while (sem_wait(&queue->items))
+  {
+    if (errno != EINTR)
+    {
+      perror("sem_wait");
+      exit(1);
+    }
+  }
+  pthread_mutex_lock(&queue->mutex);
+  size_t slot = queue->slots[queue->head];
+  queue->head = (queue->head + 1) % queue->capacity;
+  pthread_mutex_unlock(&queue->mutex);
+  return slot;
+}
+
+/**
+ * Parses the `update_count` argument of `--updates`, exiting with an error if it is not a positive number.
+ */
+size_t parseUpdateCount(char const * str)
+{
+  long long updateCount = stoll(str);
+  if (updateCount < 1)
+  {
+    fprintf(stderr, "update_count must be at least 1\n");
+    exit(-1);
+  }
+  return (size_t) updateCount;
+}
+
+/**
+ * Parses the `--warmup` option of `--benchmark`, exiting with an error if it is not a number of at least 0.
+ */
+size_t parseWarmup(char const * str)
+{
+  long long warmup = stoll(str);
+  if (warmup < 0)
+  {
+    fprintf(stderr, "warmup must be at least 0\n");
+    exit(-1);
+  }
+  return (size_t) warmup;
+}
+
+/**
+ * Parses a zero position for `runBenchmark()`: `none`, `start`, `middle` or `end`.
+ * @return `NO_ZERO` for `none`, otherwise the position in tenths of the array (0, 5 or 10)
+ */
+size_t parseZeroPosition(char const * str)
+{
+  if (strcmp(str, "none") == 0) return NO_ZERO;
+  if (strcmp(str, "start") == 0) return 0;
+  if (strcmp(str, "middle") == 0) return 5;
+  if (strcmp(str, "end") == 0) return 10;
+  fprintf(stderr, "%s is not one of none, start, middle or end\n", str);
+  exit(-1);
+}
+
+/**
+ * Starts counting the calling thread's events in `counters`.
+ * Counters that cannot be opened are left unavailable rather than treated as errors.
+ */
+void perfBegin(PerfCounters * counters)
+{
+#ifdef __linux__
+  static uint32_t const types[PERF_COUNTER_COUNT] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE,
+                                                     PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE};
+  static uint64_t const configs[PERF_COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                       PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES,
+                                                       PERF_COUNT_SW_CPU_MIGRATIONS};
+#endif
+  size_t i;
+  for (i = 0; i < PERF_COUNTER_COUNT; ++i)
+  {
+    counters->fds[i] = -1;
+    counters->values[i] = 0;
+    counters->available[i] = false;
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = types[i];
+    attr.config = configs[i];
+    attr.disabled = 1;
+    // Hardware events only need user-space counts, which unprivileged users are more often allowed
+    attr.exclude_kernel = types[i] == PERF_TYPE_HARDWARE;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    counters->fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+#ifdef __linux__
+  for (i = 0; i < PERF_COUNTER_COUNT; ++i)
+  {
+    if (counters->fds[i] >= 0)
+    {
+      ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+/**
+ * Calls `perfBegin()` on the thread's counters in `sharedState->perf`, if the threads are being instrumented.
+ */
+void perfBeginThread(ThreadInfo const * threadInfo)
+{
+  SharedState * sharedState = threadInfo->sharedState;
+  if (sharedState && sharedState->perf)
+  {
+    perfBegin(&sharedState->perf[threadInfo - sharedState->threadInfo]);
+  }
+}
+
+/**
+ * Stops counting, and reads and closes the counters started by `perfBegin()`. A counter that was multiplexed is scaled
+ * by the ratio of the time it was enabled to the time it ran; one that never ran is unavailable.
+ */
+void perfEnd(PerfCounters * counters)
+{
+  size_t i;
+  for (i = 0; i < PERF_COUNTER_COUNT; ++i)
+  {
+    if (counters->fds[i] < 0) continue;
+#ifdef __linux__
+    ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    // The value, then the time enabled and the time running, as requested by `read_format`
+    uint64_t reading[3];
+    counters->available[i] = read(counters->fds[i], reading, sizeof(reading)) == sizeof(reading) && reading[2] > 0;
+    if (counters->available[i])
+    {
+      counters->values[i] = reading[1] == reading[2] ? reading[0]
+                                                     : (uint64_t) ((double) reading[0] * reading[1] / reading[2]);
+    }
+    close(counters->fds[i]);
+    counters->fds[i] = -1;
+  }
+}
+
+/**
+ * Calls `perfEnd()` on the thread's counters in `sharedState->perf`, if the threads are being instrumented.
+ */
+void perfEndThread(ThreadInfo const * threadInfo)
+{
+  SharedState * sharedState = threadInfo->sharedState;
+  if (sharedState && sharedState->perf)
+  {
+    perfEnd(&sharedState->perf[threadInfo - sharedState->threadInfo]);
+  }
+}
+
+/**
+ * Waits until every worker in `pool` has finished the job posted by `poolStartAll()`.
+ * The pool equivalent of `joinAll()`.
+ */
+void poolJoinAll(ThreadPool * pool)
+{
+  pthread_mutex_lock(&pool->mutex);
+  while (pool->pending > 0)
+  {
+    pthread_cond_wait(&pool->jobDone, &pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Wakes every worker in `pool` to run `f(&threadInfo[i])`, without waiting for them to finish.
+ * The pool equivalent of `startAll()`. `threadInfo` must have one entry per pool thread.
+ * @param pool The pool to run on - must not already be running a job
+ * @param threadInfo An array of thread information
+ * @param f The function to run
+ */
+void poolStartAll(ThreadPool * pool, ThreadInfo * threadInfo, void * (* f)(void *))
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->threadInfo = threadInfo;
+  pool->f = f;
+  pool->pending = pool->threadCount;
+  ++pool->generation;
+  pthread_cond_broadcast(&pool->wake);
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * The body of each `ThreadPool` thread: parks until a job is posted, runs its part of the job, and signals the caller
+ * if it was the last to finish.
+ */
+void * poolWorkerMain(void * worker)
+{
+  PoolWorker * pw = (PoolWorker *) worker;
+  ThreadPool * pool = pw->pool;
+  size_t seenGeneration = 0;
+  pthread_mutex_lock(&pool->mutex);
+  while (true)
+  {
+    while (pool->generation == seenGeneration && !pool->shutdown)
+    {
+      pthread_cond_wait(&pool->wake, &pool->mutex);
+    }
+    if (pool->shutdown) break;
+    seenGeneration = pool->generation;
+    ThreadInfo * threadInfo = &pool->threadInfo[pw->index];
+    void * (* f)(void *) = pool->f;
+    pthread_mutex_unlock(&pool->mutex);
+    f(threadInfo);
+    pthread_mutex_lock(&pool->mutex);
+    if (--pool->pending == 0)
+    {
+      pthread_cond_signal(&pool->jobDone);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+  return NULL;
+}
+
+/**
+ * Prints one row of a `printPerfReport()` table. Unavailable counters are printed as `n/a`.
+ */
+void printPerfCounters(char const * label, PerfCounters const * counters)
+{
+  printf("    %-10s", label);
+  size_t i;
+  for (i = 0; i < PERF_COUNTER_COUNT; ++i)
+  {
+    if (counters->available[i])
+    {
+      printf(" %14llu", (unsigned long long) counters->values[i]);
+    }
+    else
+    {
+      printf(" %14s", "n/a");
+    }
+  }
+  if (counters->available[PERF_CYCLES] && counters->available[PERF_INSTRUCTIONS] && counters->values[PERF_CYCLES])
+  {
+    printf(" %6.2f\n", (double) counters->values[PERF_INSTRUCTIONS] / counters->values[PERF_CYCLES]);
+  }
+  else
+  {
+    printf(" %6s\n", "n/a");
+  }
+}
+
+/**
+ * Prints the performance counters of the parent and of each thread of a search, and their total.
+ * @param sharedState The shared state of the search - `perf` must hold the counters of each thread
+ * @param parent The counters of the thread that ran the search
+ * @param bytes The size of the searched data, for reporting bytes per cycle
+ */
+void printPerfReport(SharedState const * sharedState, PerfCounters const * parent, size_t bytes)
+{
+  printf("    %-10s %14s %14s %14s %14s %14s %6s\n", "thread", "cycles", "instructions", "LLC misses", "ctx switches",
+         "migrations", "IPC");
+  PerfCounters total = *parent;
+  printPerfCounters("parent", parent);
+  size_t i;
+  for (i = 0; i < sharedState->threadCount; ++i)
+  {
+    // Threads that never ran (e.g. in a sequential search) have no counters
+    PerfCounters const * counters = &sharedState->perf[i];
+    if (!counters->available[PERF_CYCLES] && !counters->available[PERF_CONTEXT_SWITCHES]) continue;
+    char label[32];
+    snprintf(label, sizeof(label), "thread %zu", i);
+    printPerfCounters(label, counters);
+    mergePerfCounters(&total, counters);
+  }
+  printPerfCounters("total", &total);
+  if (total.available[PERF_CYCLES] && total.values[PERF_CYCLES])
+  {
+    printf("    %.3f bytes/cycle\n", (double) bytes / total.values[PERF_CYCLES]);
+  }
+  else
+  {
+    printf("    Hardware counters are not available (see /proc/sys/kernel/perf_event_paranoid)\n");
+  }
+}
+
+/**
+ * If a zero was found, prints the time between the zero being found and the last thread stopping.
+ */
+void printStopLatency(SharedState const * sharedState)
+{
+  if (sharedState->zeroFoundTime != 0)
+  {
+    printf("  Zero found -> last thread stopped in %.3f us\n",
+           (double) (sharedState->lastStopTime - sharedState->zeroFoundTime) / 1000);
+  }
+  if (sharedState->observedTime != 0)
+  {
+    printf("  %s -> parent woke in %.3f us\n", sharedState->zeroFoundTime != 0 ? "Zero found" : "Last thread stopped",
+           (double) wakeLatency(sharedState) / 1000);
+  }
+}
+
+/**
+ * Prints `profile`, and the thread count and way of starting threads `chooseTuning()` picks from it for a range of
+ * array sizes.
+ */
+void printTuningProfile(TuningProfile const * profile)
+{
+  printf("Tuning profile for %zu CPU(s), %s kernel\n", profile->cpuCount, profile->kernel);
+  printf("Sequential bandwidth: %.2f GB/s\n", profile->sequentialBandwidth);
+  printf("Spawn cost: %.1f us/thread, pool wake cost: %.1f us/thread\n", profile->spawnCost / 1000,
+         profile->wakeCost / 1000);
+  printf("Chunk size: %zu\n", profile->chunkSize);
+  printf("%8s %16s\n", "threads", "bandwidth (GB/s)");
+  size_t i;
+  for (i = 0; i < profile->pointCount; ++i)
+  {
+    printf("%8zu %16.2f\n", profile->threadCounts[i], profile->bandwidths[i]);
+  }
+  printf("%12s %10s %8s\n", "array_size", "threads", "start");
+  size_t arraySize;
+  for (arraySize = 1000; arraySize <= 1000000000; arraySize *= 10)
+  {
+    size_t threadCount;
+    size_t chunkSize;
+    bool pooled;
+    if (chooseTuning(profile, arraySize, &threadCount, &chunkSize, &pooled))
+    {
+      printf("%12zu %10s %8s\n", arraySize, "sequential", "-");
+    }
+    else
+    {
+      printf("%12zu %10zu %8s\n", arraySize, threadCount, pooled ? "pool" : "spawn");
+    }
+  }
+}
+
+/**
+ * Prints the usage message for every form of the command line to `stderr`.
+ */
+void printUsage(void)
+{
+  fprintf(stderr, "%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s%s"
+          "%s%s%s%s%s%s%s%s%s%s",
+          "Usage: MTFindMin [--perf] [--affinity=POLICY] <array_size> <num_threads> <index_of_zero> [chunk_size]\n",
+          "       MTFindMin --file <path> <num_threads> [chunk_size]\n",
+          "       MTFindMin --stream <path> <num_threads> [block_size] [buffer_count]\n",
+          "       MTFindMin --write-file <path> <array_size> <index_of_zero>\n",
+          "       MTFindMin --benchmark [--sizes=LIST] [--threads=LIST] [--zeros=LIST] [--modes=LIST]\n",
+          "                             [--repetitions=N] [--warmup=N] [--chunk-size=N] [--csv=PATH] [--json=PATH]\n",
+          "       MTFindMin --regress [--scenarios=LIST] [--sizes=LIST] [--threads=N] [--seed=N] [--modes=LIST]\n",
+          "                           [--repetitions=N] [--threshold=PERCENT] [--baseline=PATH]\n",
+          "                           [--save-baseline=PATH]\n",
+          "       MTFindMin --benchmark-pool <num_threads>\n",
+          "       MTFindMin --benchmark-contention <array_size> <num_threads> [num_hogs]\n",
+          "       MTFindMin --benchmark-monitor <array_size> <num_threads>\n",
+          "       MTFindMin --benchmark-completion\n",
+          "       MTFindMin --calibrate\n",
+          "       MTFindMin --smallest <array_size> <num_threads> <k>\n",
+          "       MTFindMin --statistics <array_size> <num_threads>\n",
+          "       MTFindMin --ranges <array_size> <num_threads> <query_count>\n",
+          "       MTFindMin --updates <array_size> <num_threads> <update_count>\n",
+          "       MTFindMin --compact <array_size> <num_threads> <index_of_zero> [max_value]\n",
+          "       MTFindMin --first-below <array_size> <num_threads>\n",
+          "       MTFindMin --async <array_size> <num_threads> <search_count>\n",
+          "       MTFindMin --batch <num_threads> [workload_path]\n",
+          "array_size: The size of the array to be searched\n",
+          "num_threads: The number of threads to use, at most 4096. If 0, one thread per online CPU is used. ",
+          "If auto, the thread count, chunk size and search (sequential, or on new or pooled threads) are chosen for ",
+          "array_size from the host's tuning profile (see --calibrate), and only that search is run.\n",
+          "index_of_zero: The index in the array at which to place the zero. ",
+          "If -1, no zero will be placed.\n",
+          "chunk_size: The number of elements each thread searches between checks for early exit. Default 16384.\n",
+          "path: A file of native-endian binary `int`s, searched in place through a read-only mapping ",
+          "(--file) or written from the generated input (--write-file). For --stream, a file, pipe or - for stdin.\n",
+          "block_size: The number of integers read into each stream buffer. Default 65536.\n",
+          "buffer_count: The number of stream buffers. Default 4 per thread.\n",
+          "num_hogs: The number of CPU-bound background processes to run while benchmarking. Default 1.\n",
+          "k: The number of smallest elements (and their indices) --smallest finds.\n",
+          "query_count: The number of random ranges --ranges queries.\n",
+          "update_count: The number of random point updates, batched updates and range queries --updates times.\n",
+          "search_count: The number of searches --async keeps in flight at once, each on num_threads threads.\n",
+          "workload_path: A file listing the size in bytes of each --batch job (with an optional K, M or G suffix), ",
+          "one per line. Default: 1000 jobs of between 4 KiB and 64 MiB.\n",
+          "max_value: The greatest value --compact declares its input to have, scaling the generated values down to ",
+          "fit. If omitted, the range is detected.\n",
+          "--affinity pins each thread to a CPU read from /sys: compact (fill each core, then the next), scatter ",
+          "(spread across NUMA nodes, then cores, then SMT siblings), physical (one thread per core) or none.\n",
+          "--calibrate measures the host's sequential bandwidth, thread spawn and wake costs and scaling curve, and ",
+          "caches them in $MTFINDMIN_PROFILE (default ~/.cache/mtfindmin.profile), as the first auto run does.\n",
+          "--perf reports hardware performance counters for the parent and each thread of every search. It only ",
+          "applies to the first form.\n",
+          "--benchmark sweeps every combination of the comma-separated --sizes (default " BENCHMARK_SIZES "), ",
+          "--threads (default " BENCHMARK_THREAD_COUNTS ") and --zeros (any of none, start, middle and end; default ",
+          BENCHMARK_ZEROS ") over the --modes (default all), and writes the timing statistics as CSV and/or JSON.\n",
+          "Modes: sequential, joined, busy-wait, semaphore, barrier, condition, spin-futex, eventfd, dynamic, ",
+          "pool and library. Each is timed end to end, and by how long its parent takes to wake once the last ",
+          "thread stops (or a zero is found).\n",
+          "--regress runs the --modes over every --scenarios (default all: uniform-zero, no-zero, sorted, ",
+          "reverse-sorted, duplicates, boundary-zeros and last-zero) of each of the --sizes ",
+          "(default " REGRESSION_SIZES "), checks every result against a sequential search, and fails if a median ",
+          "throughput is more than --threshold percent (default 10) below that in the --baseline CSV, which ",
+          "--save-baseline writes.\n");
+}
+
+/**
+ * Adds `slot` to the back of `queue`, waking a thread waiting in `popSlot()`.
+ */
+void pushSlot(SlotQueue * queue, size_t slot)
+{
+  pthread_mutex_lock(&queue->mutex);
+  queue->slots[queue->tail] = slot;
+  queue->tail = (queue->tail + 1) % queue->capacity;
+  pthread_mutex_unlock(&queue->mutex);
+  if (sem_post(&queue->items))
+  {
+    perror("sem_post");
+    exit(1);
+  }
+}
+
+/**
+ * Returns the element at `index` of the pseudo-random stream of 64-bit values for `seed`.
+ * Counter-based: the SplitMix64 finalizer is applied to `seed + (index + 1) * golden ratio`, so each element is
+ * computed independently of the others and disjoint ranges can be filled in parallel with identical results.
+ */
+uint64_t randomBits(uint64_t seed, uint64_t index)
+{
+  uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * Reads the first line of a small file, such as one under /sys, into `buffer`.
+ * @return `false` if the file could not be read
+ */
+bool readSysFile(char const * path, char * buffer, size_t size)
+{
+  FILE * file = fopen(path, "r");
+  if (!file) return false;
+  bool read = fgets(buffer, (int) size, file) != NULL;
+  fclose(file);
+  return read;
+}
+
+/**
+ * Reads the integer in a file under /sys, or returns `fallback` if it cannot be read.
+ */
+int readSysInt(char const * path, int fallback)
+{
+  char buffer[64];
+  if (!readSysFile(path, buffer, sizeof(buffer))) return fallback;
+  char * end;
+  long value = strtol(buffer, &end, 10);
+  return end == buffer ? fallback : (int) value;
+}
+
+/**
+ * Reads a workload file for `--batch`: one job per line, given as its size in bytes with an optional `K`, `M` or `G`
+ * (binary) suffix. Blank lines and lines starting with `#` are skipped. Exits with an error if the file cannot be read
+ * or has no jobs.
+ * Note: allocates `*sizes` dynamically - it should be freed.
+ * @param sizes Set to the number of elements of each job
+ * @return The number of jobs
+ */
+size_t readWorkload(char const * path, size_t ** sizes)
+{
+  FILE * file = fopen(path, "r");
+  if (!file)
+  {
+    perror(path);
+    exit(1);
+  }
+  size_t count = 0;
+  size_t capacity = 64;
+  *sizes = (size_t *) malloc(capacity * sizeof(size_t));
+  if (!*sizes)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  char line[256];
+  size_t lineNumber = 0;
+  while (fgets(line, sizeof(line), file))
+  {
+    ++lineNumber;
+    char * start = line + strspn(line, " \t");
+    if (*start == '#' || *start == '\n' || *start == '\0') continue;
+    char * end;
+    errno = 0;
+    unsigned long long bytes = strtoull(start, &end, 10);
+    size_t shift = *end == 'K' ? 10 : *end == 'M' ? 20 : *end == 'G' ? 30 : 0;
+    end += shift > 0;
+    if (errno || end == start || end[strspn(end, " \t\r\n")] != '\0' || bytes == 0 || bytes > (SIZE_MAX >> shift))
+    {
+      fprintf(stderr, "%s:%zu: expected a size in bytes, optionally followed by K, M or G\n", path, lineNumber);
+      exit(-1);
+    }
+    if (count == capacity)
+    {
+      capacity *= 2;
+      *sizes = (size_t *) realloc(*sizes, capacity * sizeof(size_t));
+      if (!*sizes)
+      {
+        perror("realloc");
+        exit(1);
+      }
+    }
+    size_t elements = (size_t) (bytes << shift) / sizeof(int);
+    (*sizes)[count++] = elements > 0 ? elements : 1;
+  }
+  fclose(file);
+  if (count == 0)
+  {
+    fprintf(stderr, "%s has no jobs\n", path);
+    exit(-1);
+  }
+  return count;
+}
+
+/**
+ * Returns the element at `index` of the pseudo-random stream for `seed`, between 1 and `MAX_RANDOM_NUMBER`.
+ */
+int randomValue(uint64_t seed, uint64_t index)
+{
+  // Map the top 32 bits onto [0, MAX_RANDOM_NUMBER) by multiplication rather than modulo
+  return (int) (((randomBits(seed, index) >> 32) * MAX_RANDOM_NUMBER) >> 32) + 1;
+}
+
+/**
+ * Records the current time as `benchmark->lastArrivalTime`, if it is later than the time already recorded.
+ */
+void recordArrival(CompletionBenchmark * benchmark)
+{
+  uint64_t arrivalTime = now();
+  uint64_t lastArrivalTime = __atomic_load_n(&benchmark->lastArrivalTime, __ATOMIC_RELAXED);
+  while (arrivalTime > lastArrivalTime &&
+         !__atomic_compare_exchange_n(&benchmark->lastArrivalTime, &lastArrivalTime, arrivalTime, true,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+  {
+  }
+}
+
+/**
+ * Records that a thread has stopped searching, keeping `lastStopTime` at the latest stop.
+ */
+void reportStopped(SharedState * sharedState)
+{
+  uint64_t time = now();
+  uint64_t last = __atomic_load_n(&sharedState->lastStopTime, __ATOMIC_RELAXED);
+  while (time > last &&
+         !__atomic_compare_exchange_n(&sharedState->lastStopTime, &last, time, false, __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED))
+  {
+  }
+}
+
+/**
+ * Records that a zero was found, and stops every other thread sharing `sharedState` if `stopOnZero` is set.
+ */
+void reportZero(SharedState * sharedState)
+{
+  uint64_t none = 0;
+  if (!sharedState->stopOnZero) return;
+  __atomic_compare_exchange_n(&sharedState->zeroFoundTime, &none, now(), false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+  cancelAll(sharedState);
+}
+
+/**
+ * Generates an array, packs it into as few bytes per element as its range allows with `packInput()`, and compares the
+ * time taken to find the minimum of the packed array against that of the array of `int`s.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each search
+ * @param indexOfZero The index at which to place a zero, or `NO_ZERO`
+ * @param maxValue The declared greatest value, to which the generated values are scaled down - or 0 to detect the
+ *                 range of the values as generated
+ * @return The exit status: 0 if both searches find the same minimum, 1 otherwise
+ */
+int searchCompact(size_t arraySize, size_t threadCount, size_t indexOfZero, int maxValue)
+{
+  int * data = generateInput(arraySize, indexOfZero, threadCount);
+  FindMinOptions options;
+  options.threadCount = threadCount;
+  options.chunkSize = FIND_MIN_CHUNK_SIZE;
+  int lowest = 0;
+  int highest = maxValue;
+  size_t i;
+  if (maxValue > 0)
+  {
+    for (i = 0; i < arraySize; ++i)
+    {
+      data[i] = data[i] == 0 ? 0 : (data[i] - 1) * maxValue / MAX_RANDOM_NUMBER + 1;
+    }
+  }
+  else
+  {
+    FindMinReductionInt32 reduction;
+    reduction.statistics = FIND_MIN_MINIMUM | FIND_MIN_MAXIMUM;
+    findMinReduceInt32(data, arraySize, &reduction, &options);
+    lowest = reduction.minimum;
+    highest = reduction.maximum;
+  }
+  uint64_t startTime = now();
+  PackedInput packed;
+  packInput(&packed, data, arraySize, lowest, highest);
+  printf("Range [%d, %d] (%s) packed in %.3f ms into %zu-byte elements with base %d: %zu bytes instead of %zu\n",
+         lowest, highest, maxValue > 0 ? "declared" : "detected", (double) timeSince(startTime) / 1000000,
+         packed.width, packed.base, arraySize * packed.width, arraySize * sizeof(int));
+  uint64_t samples[STATISTICS_REPETITIONS];
+  double medians[2];
+  int minima[2];
+  printf("%-10s %12s %10s\n", "storage", "median (ms)", "GB/s");
+  size_t pass;
+  for (pass = 0; pass < 2; ++pass)
+  {
+    size_t repetition;
+    for (repetition = 0; repetition < STATISTICS_REPETITIONS; ++repetition)
+    {
+      startTime = now();
+      minima[pass] = pass == 0 ? findMinInt32(data, arraySize, &options) : findMinPacked(&packed, &options);
+      samples[repetition] = timeSince(startTime);
+    }
+    medians[pass] = computeStatistics(samples, STATISTICS_REPETITIONS).median;
+    size_t width = pass == 0 ? sizeof(int) : packed.width;
+    printf("%-10s %12.3f %10.2f\n", pass == 0 ? "int" : "packed", medians[pass] / 1000000,
+           arraySize * width / medians[pass]);
+  }
+  printf("Min = %d (packed: %d), packed search %.2fx as fast\n", minima[0], minima[1], medians[0] / medians[1]);
+  if (minima[0] != minima[1])
+  {
+    printf("The packed minimum disagrees with findMinInt32()\n");
+  }
+  freePackedInput(&packed);
+  freeInput(data, arraySize);
+  return minima[0] == minima[1] ? 0 : 1;
+}
+
+/**
+ * Searches a file of binary `int`s for its minimum without copying it, splitting the mapping into per-thread regions.
+ * The file is searched twice: first with its pages evicted from the page cache (cold), then again with the pages
+ * cached by the first search (warm). The time and throughput of each search are reported separately.
+ * @param path The file to search
+ * @param threadCount The number of threads to search with
+ * @param chunkSize The number of elements each thread searches between checks for early exit
+ */
+void searchFile(char const * path, size_t threadCount, size_t chunkSize)
+{
+  static char const * const passNames[] = {"cold", "warm"};
+  int pass;
+  for (pass = 0; pass < 2; ++pass)
+  {
+    size_t size;
+    uint64_t startTime = now();
+    int const * data = mapInputFile(path, &size, pass == 0);
+    SharedState sharedState = initSharedState(threadCount, chunkSize);
+    ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, &sharedState);
+    startAll(threadInfo, threadCount, findMinThreaded);
+    joinAll(threadInfo, threadCount);
+    int min = searchThreadMinima(threadCount, threadInfo);
+    double seconds = (double) timeSince(startTime) / 1000000000;
+    printf("File search (%s cache) of %zu integers completed in %.1f ms (%.2f GB/s). Min = %d\n", passNames[pass], size,
+           seconds * 1000, size * sizeof(int) / seconds / 1000000000, min);
+    printStopLatency(&sharedState);
+    free(threadInfo);
+    munmap((void *) data, size * sizeof(int));
+  }
+}
+
+/**
+ * Times `findFirstBelowInt32()` on `threadCount` threads against a sequential scan (the same search on one thread),
+ * for a generated array (with no zero) into which a zero is placed near its start, in its middle, near its end or not
+ * at all, and checks that both find it. Only the zero is below the threshold of 1.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by the parallel search
+ * @return The exit status: 0 if both searches find every zero, 1 otherwise
+ */
+int searchFirstBelow(size_t arraySize, size_t threadCount)
+{
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  size_t const positions[] = {arraySize / 100, arraySize / 2, arraySize - 1 - arraySize / 100, NO_ZERO};
+  char const * const positionNames[] = {"start", "middle", "end", "none"};
+  FindMinOptions options[2];
+  options[0].threadCount = threadCount;
+  options[1].threadCount = 1;
+  options[0].chunkSize = options[1].chunkSize = FIND_MIN_CHUNK_SIZE;
+  uint64_t samples[STATISTICS_REPETITIONS];
+  size_t mismatches = 0;
+  printf("%-8s %12s %15s %17s %8s\n", "zero", "index", "parallel (ms)", "sequential (ms)", "speedup");
+  size_t position;
+  for (position = 0; position < sizeof(positions) / sizeof(positions[0]); ++position)
+  {
+    size_t index = positions[position];
+    if (index != NO_ZERO)
+    {
+      data[index] = 0;
+    }
+    double medians[2];
+    size_t found[2];
+    size_t search;
+    for (search = 0; search < 2; ++search)
+    {
+      size_t repetition;
+      for (repetition = 0; repetition < STATISTICS_REPETITIONS; ++repetition)
+      {
+        uint64_t startTime = now();
+        found[search] = findFirstBelowInt32(data, arraySize, 1, &options[search]);
+        samples[repetition] = timeSince(startTime);
+      }
+      medians[search] = computeStatistics(samples, STATISTICS_REPETITIONS).median;
+    }
+    if (found[0] != index || found[1] != index)
+    {
+      fprintf(stderr, "Expected the first zero at %zu, but found %zu (parallel) and %zu (sequential)\n", index,
+              found[0], found[1]);
+      ++mismatches;
+    }
+    char indexString[32];
+    snprintf(indexString, sizeof(indexString), index == NO_ZERO ? "-" : "%zu", index);
+    printf("%-8s %12s %15.3f %17.3f %7.2fx\n", positionNames[position], indexString, medians[0] / 1000000,
+           medians[1] / 1000000, medians[1] / medians[0]);
+    if (index != NO_ZERO)
+    {
+      data[index] = randomValue(RANDOM_SEED, index);
+    }
+  }
+  freeInput(data, arraySize);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Finds the minimum, the index of the minimum and the `k` smallest elements of a generated array (with no zero) with
+ * the FindMin library, and prints how long each took along with the results. The results are then checked against a
+ * plain scan, ties included: the index of the minimum must be its first, and the `k` smallest must be the `k` first in
+ * ascending order of value and then index.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each search
+ * @param k The number of smallest elements to find
+ * @return The exit status: 0 if every result agrees with the scan, 1 otherwise
+ */
+int searchSmallest(size_t arraySize, size_t threadCount, size_t k)
+{
+  k = k < arraySize ? k : arraySize;
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  int * values = (int *) malloc(k * sizeof(int));
+  size_t * indices = (size_t *) malloc(k * sizeof(size_t));
+  if (!values || !indices)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  FindMinOptions options;
+  options.threadCount = threadCount;
+  options.chunkSize = FIND_MIN_CHUNK_SIZE;
+  uint64_t startTime = now();
+  int min = findMinInt32(data, arraySize, &options);
+  printf("Minimum found in %.3f ms. Min = %d\n", (double) timeSince(startTime) / 1000000, min);
+  startTime = now();
+  size_t minIndex = findArgMinInt32(data, arraySize, &options);
+  printf("Index of the minimum found in %.3f ms. data[%zu] = %d\n", (double) timeSince(startTime) / 1000000, minIndex,
+         data[minIndex]);
+  startTime = now();
+  size_t count = findSmallestInt32(data, arraySize, k, values, indices, &options);
+  printf("%zu smallest found in %.3f ms.\n", count, (double) timeSince(startTime) / 1000000);
+  size_t i;
+  for (i = 0; i < count; ++i)
+  {
+    printf("  data[%zu] = %d\n", indices[i], values[i]);
+  }
+  size_t referenceIndex = 0;
+  for (i = 1; i < arraySize; ++i)
+  {
+    referenceIndex = data[i] < data[referenceIndex] ? i : referenceIndex;
+  }
+  size_t mismatches = (min != data[referenceIndex]) + (minIndex != referenceIndex) + (count != k);
+  // The results are the `k` smallest if they are in ascending order of value and then index, and exactly `count`
+  // elements of the array come no later than the last of them in that order
+  for (i = 0; i < count; ++i)
+  {
+    bool ordered = i == 0 || values[i] > values[i - 1] || (values[i] == values[i - 1] && indices[i] > indices[i - 1]);
+    mismatches += !ordered || indices[i] >= arraySize || data[indices[i]] != values[i];
+  }
+  if (count > 0 && mismatches == 0)
+  {
+    size_t notLater = 0;
+    for (i = 0; i < arraySize; ++i)
+    {
+      notLater += data[i] < values[count - 1] || (data[i] == values[count - 1] && i <= indices[count - 1]);
+    }
+    mismatches += notLater != count;
+  }
+  printf("%zu results disagree with a plain scan\n", mismatches);
+  free(values);
+  free(indices);
+  freeInput(data, arraySize);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Computes the minimum, maximum, sum, count below `MAX_RANDOM_NUMBER / 10` and a histogram of a generated array with
+ * `findMinReduceInt32()`, and compares the time taken by the fused pass (with and without the histogram) against a
+ * plain min scan and against one pass per statistic. The results of both are then checked against a plain scan.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each pass
+ * @return The exit status: 0 if the fused and separate passes agree with the scan, 1 otherwise
+ */
+int searchStatistics(size_t arraySize, size_t threadCount)
+{
+  static unsigned const statistics[] = {FIND_MIN_MINIMUM, FIND_MIN_MAXIMUM, FIND_MIN_SUM, FIND_MIN_COUNT_BELOW,
+                                        FIND_MIN_HISTOGRAM};
+  static size_t const statisticCount = sizeof(statistics) / sizeof(statistics[0]);
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  FindMinOptions options;
+  options.threadCount = threadCount;
+  options.chunkSize = FIND_MIN_CHUNK_SIZE;
+  size_t bins[STATISTICS_BIN_COUNT];
+  FindMinReductionInt32 reduction;
+  reduction.threshold = MAX_RANDOM_NUMBER / 10;
+  reduction.histogramLow = 1;
+  reduction.histogramHigh = MAX_RANDOM_NUMBER + 1;
+  reduction.binCount = STATISTICS_BIN_COUNT;
+  reduction.bins = bins;
+  uint64_t samples[STATISTICS_REPETITIONS];
+  char const * const passNames[] = {"min scan", "fused (no histogram)", "fused", "one pass per statistic"};
+  printf("%-24s %12s %10s\n", "passes", "median (ms)", "GB/s");
+  size_t pass;
+  for (pass = 0; pass < 4; ++pass)
+  {
+    size_t repetition;
+    for (repetition = 0; repetition < STATISTICS_REPETITIONS; ++repetition)
+    {
+      uint64_t startTime = now();
+      if (pass == 0)
+      {
+        findMinInt32(data, arraySize, &options);
+      }
+      else if (pass < 3)
+      {
+        reduction.statistics = FIND_MIN_MINIMUM | FIND_MIN_MAXIMUM | FIND_MIN_SUM | FIND_MIN_COUNT_BELOW |
+                               (pass == 2 ? FIND_MIN_HISTOGRAM : 0);
+        findMinReduceInt32(data, arraySize, &reduction, &options);
+      }
+      else
+      {
+        size_t i;
+        for (i = 0; i < statisticCount; ++i)
+        {
+          reduction.statistics = statistics[i];
+          findMinReduceInt32(data, arraySize, &reduction, &options);
+        }
+      }
+      samples[repetition] = timeSince(startTime);
+    }
+    Statistics timing = computeStatistics(samples, STATISTICS_REPETITIONS);
+    printf("%-24s %12.3f %10.2f\n", passNames[pass], timing.median / 1000000, arraySize * sizeof(int) / timing.median);
+  }
+  printf("Min = %d, max = %d, mean = %.3f, %zu below %d\n", reduction.minimum, reduction.maximum,
+         (double) reduction.sum / arraySize, reduction.countBelow, reduction.threshold);
+  size_t bin;
+  for (bin = 0; bin < STATISTICS_BIN_COUNT; ++bin)
+  {
+    printf("  [%d, %d): %zu\n", 1 + MAX_RANDOM_NUMBER * (int) bin / STATISTICS_BIN_COUNT,
+           1 + MAX_RANDOM_NUMBER * (int) (bin + 1) / STATISTICS_BIN_COUNT, bins[bin]);
+  }
+  int referenceMin = INT_MAX;
+  int referenceMax = INT_MIN;
+  int64_t referenceSum = 0;
+  size_t referenceCountBelow = 0;
+  size_t referenceBins[STATISTICS_BIN_COUNT] = {0};
+  size_t i;
+  for (i = 0; i < arraySize; ++i)
+  {
+    referenceMin = data[i] < referenceMin ? data[i] : referenceMin;
+    referenceMax = data[i] > referenceMax ? data[i] : referenceMax;
+    referenceSum += data[i];
+    referenceCountBelow += data[i] < reduction.threshold;
+    if (data[i] >= reduction.histogramLow && data[i] < reduction.histogramHigh)
+    {
+      ++referenceBins[(int64_t) (data[i] - reduction.histogramLow) * STATISTICS_BIN_COUNT /
+                      (reduction.histogramHigh - reduction.histogramLow)];
+    }
+  }
+  // `reduction` holds the results of the separate passes; `fused` gets those of one more fused pass
+  size_t fusedBins[STATISTICS_BIN_COUNT];
+  FindMinReductionInt32 fused = reduction;
+  fused.statistics = FIND_MIN_MINIMUM | FIND_MIN_MAXIMUM | FIND_MIN_SUM | FIND_MIN_COUNT_BELOW | FIND_MIN_HISTOGRAM;
+  fused.bins = fusedBins;
+  findMinReduceInt32(data, arraySize, &fused, &options);
+  FindMinReductionInt32 const * const results[] = {&reduction, &fused};
+  size_t mismatches = 0;
+  size_t result;
+  for (result = 0; result < 2; ++result)
+  {
+    FindMinReductionInt32 const * r = results[result];
+    mismatches += (r->minimum != referenceMin) + (r->maximum != referenceMax) + (r->sum != referenceSum) +
+                  (r->countBelow != referenceCountBelow);
+    for (bin = 0; bin < STATISTICS_BIN_COUNT; ++bin)
+    {
+      mismatches += r->bins[bin] != referenceBins[bin];
+    }
+  }
+  printf("%zu statistics of the fused and separate passes disagree with a plain scan\n", mismatches);
+  freeInput(data, arraySize);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Finds the minimum of a stream of binary `int`s that may not fit in memory, such as a pipe.
+ * A reader thread fills a fixed ring of `bufferCount` buffers while `threadCount` worker threads search them, so
+ * reading overlaps with searching and memory use does not grow with the length of the stream. The whole pipeline stops
+ * as soon as a zero is read.
+ * @param path The file or pipe to read, or `-` for stdin
+ * @param threadCount The number of worker threads
+ * @param blockSize The number of integers in each buffer
+ * @param bufferCount The number of buffers
+ */
+void searchStream(char const * path, size_t threadCount, size_t blockSize, size_t bufferCount)
+{
+  // The filled slot queue also holds one end-of-stream marker per worker
+  if (blockSize > SIZE_MAX / sizeof(int) / bufferCount || bufferCount > SIZE_MAX / sizeof(size_t) - threadCount)
+  {
+    fprintf(stderr, "block_size * buffer_count is too large\n");
+    exit(-1);
+  }
+  StreamState stream;
+  stream.fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+  if (stream.fd < 0)
+  {
+    perror(path);
+    exit(1);
+  }
+  if (pipe(stream.wakePipe))
+  {
+    perror("pipe");
+    exit(1);
+  }
+  stream.blockSize = blockSize;
+  stream.bufferCount = bufferCount;
+  stream.buffers = (int *) malloc(bufferCount * blockSize * sizeof(int));
+  stream.blockLengths = (size_t *) malloc(bufferCount * sizeof(size_t));
+  if (!stream.buffers || !stream.blockLengths)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  // Room for every slot, plus one end-of-stream marker per worker
+  initSlotQueue(&stream.freeSlots, bufferCount);
+  initSlotQueue(&stream.filledSlots, bufferCount + threadCount);
+  size_t i;
+  for (i = 0; i < bufferCount; ++i)
+  {
+    pushSlot(&stream.freeSlots, i);
+  }
+  SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+  stream.sharedState = &sharedState;
+  stream.minimum = INT_MAX;
+  stream.elementCount = 0;
+  pthread_t reader;
+  pthread_t * workers = (pthread_t *) malloc(threadCount * sizeof(pthread_t));
+  if (!workers)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  uint64_t startTime = now();
+  if (pthread_create(&reader, NULL, streamReaderMain, &stream))
+  {
+    perror("pthread_create");
+    exit(1);
+  }
+  for (i = 0; i < threadCount; ++i)
+  {
+    if (pthread_create(&workers[i], NULL, streamWorkerMain, &stream))
+    {
+      perror("pthread_create");
+      exit(1);
+    }
+  }
+  for (i = 0; i < threadCount; ++i)
+  {
+    if (pthread_join(workers[i], NULL))
+    {
+      perror("pthread_join");
+      exit(1);
+    }
+  }
+  if (pthread_join(reader, NULL))
+  {
+    perror("pthread_join");
+    exit(1);
+  }
+  double seconds = (double) timeSince(startTime) / 1000000000;
+  printf("Stream search of %zu integers completed in %.1f ms (%.2f GB/s). Min = %d\n", stream.elementCount,
+         seconds * 1000, stream.elementCount * sizeof(int) / seconds / 1000000000, stream.minimum);
+  printStopLatency(&sharedState);
+  freeSlotQueue(&stream.filledSlots);
+  freeSlotQueue(&stream.freeSlots);
+  free(workers);
+  free(stream.blockLengths);
+  free(stream.buffers);
+  close(stream.wakePipe[0]);
+  close(stream.wakePipe[1]);
+  if (stream.fd != STDIN_FILENO)
+  {
+    close(stream.fd);
+  }
+}
+
+/**
+ * Finds the minimum of each of `jobCount` independent arrays on a batch engine of `threadCount` workers. Jobs of up
+ * to `BATCH_SPLIT_SIZE` elements are searched whole by one worker; larger ones are split into one region per worker,
+ * as `computeThreadInfo()` splits an array. The tasks of every job go through one FIFO queue, so a worker moves on to
+ * the next job's tasks the moment it is done, without waiting for the rest of the current job.
+ * Sets the `minimum`, `startTime` and `latency` of every job.
+ */
+void runBatch(BatchJob * jobs, size_t jobCount, size_t threadCount)
+{
+  size_t taskCount = 0;
+  size_t i;
+  for (i = 0; i < jobCount; ++i)
+  {
+    taskCount += jobs[i].size > BATCH_SPLIT_SIZE ? threadCount : 1;
+  }
+  BatchEngine engine;
+  engine.tasks = (BatchTask *) malloc(taskCount * sizeof(BatchTask));
+  pthread_t * workers = (pthread_t *) malloc(threadCount * sizeof(pthread_t));
+  if (!engine.tasks || !workers)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  // Room for every task, plus one end-of-queue marker per worker
+  initSlotQueue(&engine.queue, taskCount + threadCount);
+  for (i = 0; i < threadCount; ++i)
+  {
+    pthread_attr_t attr;
+    initThreadAttr(&attr, i);
+    if (pthread_create(&workers[i], &attr, batchWorkerMain, &engine))
+    {
+      perror("pthread_create");
+      exit(1);
+    }
+    pthread_attr_destroy(&attr);
+  }
+  size_t task = 0;
+  for (i = 0; i < jobCount; ++i)
+  {
+    BatchJob * job = &jobs[i];
+    size_t regionCount = job->size > BATCH_SPLIT_SIZE ? threadCount : 1;
+    job->minimum = INT_MAX;
+    job->remaining = regionCount;
+    job->startTime = 0;
+    job->submitTime = now();
+    size_t region;
+    for (region = 0; region < regionCount; ++region, ++task)
+    {
+      engine.tasks[task].job = job;
+      engine.tasks[task].begin = region * job->size / regionCount;
+      engine.tasks[task].end = (region + 1) * job->size / regionCount;
+      pushSlot(&engine.queue, task);
+    }
+  }
+  for (i = 0; i < threadCount; ++i)
+  {
+    pushSlot(&engine.queue, END_OF_STREAM);
+  }
+  for (i = 0; i < threadCount; ++i)
+  {
+    if (pthread_join(workers[i], NULL))
+    {
+      perror("pthread_join");
+      exit(1);
+    }
+  }
+  freeSlotQueue(&engine.queue);
+  free(engine.tasks);
+  free(workers);
+}
+
+/**
+ * Runs the benchmark sweep selected by the `--benchmark` options in `argv` (see the usage message in `main()`).
+ * Every selected mode is timed over every combination of array size, thread count and zero position: `warmup`
+ * untimed searches, then `repetitions` timed ones, summarized by `computeStatistics()`. Results are printed as a
+ * table, and optionally written as CSV and/or JSON to track regressions between builds.
+ * @param argc The number of arguments in `argv`
+ * @param argv The arguments, starting with `--benchmark` itself
+ * @return The exit status
+ */
+int runBenchmark(int argc, char const ** argv)
+{
+  static struct option const options[] = {
+    {"sizes", required_argument, NULL, 's'},
+    {"threads", required_argument, NULL, 't'},
+    {"zeros", required_argument, NULL, 'z'},
+    {"modes", required_argument, NULL, 'm'},
+    {"repetitions", required_argument, NULL, 'r'},
+    {"warmup", required_argument, NULL, 'w'},
+    {"chunk-size", required_argument, NULL, 'c'},
+    {"csv", required_argument, NULL, 'C'},
+    {"json", required_argument, NULL, 'J'},
+    {NULL, 0, NULL, 0}
+  };
+  char const * sizeList = BENCHMARK_SIZES;
+  char const * threadList = BENCHMARK_THREAD_COUNTS;
+  char const * zeroList = BENCHMARK_ZEROS;
+  char const * modeList = NULL;
+  size_t repetitions = BENCHMARK_REPETITIONS;
+  size_t warmup = BENCHMARK_WARMUP;
+  size_t chunkSize = FIND_MIN_CHUNK_SIZE;
+  char const * csvPath = NULL;
+  char const * jsonPath = NULL;
+  int option;
+  while ((option = getopt_long(argc, (char * const *) argv, "", options, NULL)) != -1)
+  {
+    switch (option)
+    {
+      case 's': sizeList = optarg; break;
+      case 't': threadList = optarg; break;
+      case 'z': zeroList = optarg; break;
+      case 'm': modeList = optarg; break;
+      case 'r': repetitions = parseRepetitions(optarg); break;
+      case 'w': warmup = parseWarmup(optarg); break;
+      case 'c': chunkSize = parseChunkSize(optarg); break;
+      case 'C': csvPath = optarg; break;
+      case 'J': jsonPath = optarg; break;
+      default: printUsage(); return -1;
+    }
+  }
+  if (optind != argc)
+  {
+    printUsage();
+    return -1;
+  }
+  size_t * sizes;
+  size_t sizeCount = parseList(sizeList, &sizes, parseArraySize);
+  size_t * threadCounts;
+  size_t threadCountCount = parseList(threadList, &threadCounts, parseThreadCount);
+  size_t * zeros;
+  size_t zeroCount = parseList(zeroList, &zeros, parseZeroPosition);
+  bool * modeSelected = parseSelection(modeList, searchModes, searchModeCount, sizeof(searchModes[0]), "search mode");
+  size_t mode;
+  FILE * csv = csvPath ? fopen(csvPath, "w") : NULL;
+  FILE * json = jsonPath ? fopen(jsonPath, "w") : NULL;
+  if ((csvPath && !csv) || (jsonPath && !json))
+  {
+    perror(csvPath && !csv ? csvPath : jsonPath);
+    exit(1);
+  }
+  if (csv)
+  {
+    fprintf(csv, "kernel,mode,array_size,threads,zero_index,repetitions,min_ns,median_ns,p90_ns,p99_ns,max_ns,mean_ns,"
+                 "stddev_ns,median_gbps,result,wake_median_ns,wake_p99_ns\n");
+  }
+  if (json)
+  {
+    fprintf(json, "{\n  \"kernel\": \"%s\",\n  \"repetitions\": %zu,\n  \"warmup\": %zu,\n  \"results\": [",
+            findMinKernelName(), repetitions, warmup);
+  }
+  printf("%-10s %12s %7s %12s %12s %12s %12s %12s %9s %5s %10s %10s\n", "mode", "array_size", "threads", "zero_index",
+         "min (us)", "median (us)", "p90 (us)", "p99 (us)", "GB/s", "min", "wake (us)", "wake p99");
+  uint64_t * samples = (uint64_t *) malloc(repetitions * sizeof(uint64_t));
+  uint64_t * wakeSamples = (uint64_t *) malloc(repetitions * sizeof(uint64_t));
+  bool firstResult = true;
+  size_t sizeIndex, zeroIndex, threadIndex;
+  for (sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex)
+  {
+    size_t size = sizes[sizeIndex];
+    for (zeroIndex = 0; zeroIndex < zeroCount; ++zeroIndex)
+    {
+      size_t indexOfZero = zeros[zeroIndex] == NO_ZERO ? NO_ZERO : (size - 1) * zeros[zeroIndex] / 10;
+      int * data = generateInput(size, indexOfZero, threadCounts[threadCountCount - 1]);
+      for (threadIndex = 0; threadIndex < threadCountCount; ++threadIndex)
+      {
+        size_t threadCount = threadCounts[threadIndex];
+        ThreadPool * pool = createThreadPool(threadCount);
+        for (mode = 0; mode < searchModeCount; ++mode)
+        {
+          if (!modeSelected[mode]) continue;
+          int min = 0;
+          bool observed = true;
+          size_t repetition;
+          for (repetition = 0; repetition < warmup + repetitions; ++repetition)
+          {
+            SharedState sharedState = initSharedState(threadCount, chunkSize);
+            uint64_t startTime = now();
+            min = searchModes[mode].search(data, size, &sharedState, pool);
+            uint64_t elapsed = timeSince(startTime);
+            if (repetition >= warmup)
+            {
+              samples[repetition - warmup] = elapsed;
+              wakeSamples[repetition - warmup] = wakeLatency(&sharedState);
+              observed = observed && sharedState.observedTime != 0;
+            }
+          }
+          Statistics statistics = computeStatistics(samples, repetitions);
+          Statistics wake = computeStatistics(wakeSamples, repetitions);
+          char wakeMedian[32] = "-";
+          char wakeP99[32] = "-";
+          if (observed)
+          {
+            snprintf(wakeMedian, sizeof(wakeMedian), "%.1f", wake.median / 1000);
+            snprintf(wakeP99, sizeof(wakeP99), "%.1f", wake.p99 / 1000);
+          }
+          double gigabytesPerSecond = size * sizeof(int) / statistics.median;
+          long long zeroIndexOutput = indexOfZero == NO_ZERO ? -1 : (long long) indexOfZero;
+          printf("%-10s %12zu %7zu %12lld %12.1f %12.1f %12.1f %12.1f %9.2f %5d %10s %10s\n", searchModes[mode].name,
+                 size, threadCount, zeroIndexOutput, statistics.min / 1000, statistics.median / 1000,
+                 statistics.p90 / 1000, statistics.p99 / 1000, gigabytesPerSecond, min, wakeMedian, wakeP99);
+          if (csv)
+          {
+            fprintf(csv, "%s,%s,%zu,%zu,%lld,%zu,%.0f,%.0f,%.0f,%.0f,%.0f,%.1f,%.1f,%.3f,%d,", findMinKernelName(),
+                    searchModes[mode].name, size, threadCount, zeroIndexOutput, repetitions, statistics.min,
+                    statistics.median, statistics.p90, statistics.p99, statistics.max, statistics.mean,
+                    statistics.stddev, gigabytesPerSecond, min);
+            if (observed)
+            {
+              fprintf(csv, "%.0f,%.0f\n", wake.median, wake.p99);
+            }
+            else
+            {
+              fprintf(csv, ",\n");
+            }
+          }
+          if (json)
+          {
+            char wakeMedianNs[32];
+            char wakeP99Ns[32];
+            snprintf(wakeMedianNs, sizeof(wakeMedianNs), "%.0f", wake.median);
+            snprintf(wakeP99Ns, sizeof(wakeP99Ns), "%.0f", wake.p99);
+            fprintf(json, "%s\n    {\"mode\": \"%s\", \"array_size\": %zu, \"threads\": %zu, \"zero_index\": %lld, "
+                          "\"min_ns\": %.0f, \"median_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, "
+                          "\"max_ns\": %.0f, \"mean_ns\": %.1f, \"stddev_ns\": %.1f, \"median_gbps\": %.3f, "
+                          "\"result\": %d, \"wake_median_ns\": %s, \"wake_p99_ns\": %s}",
+                    firstResult ? "" : ",", searchModes[mode].name, size, threadCount, zeroIndexOutput,
+                    statistics.min, statistics.median, statistics.p90, statistics.p99, statistics.max,
+                    statistics.mean, statistics.stddev, gigabytesPerSecond, min, observed ? wakeMedianNs : "null",
+                    observed ? wakeP99Ns : "null");
+          }
+          firstResult = false;
+        }
+        destroyThreadPool(pool);
+      }
+      freeInput(data, size);
+    }
+  }
+  if (csv)
+  {
+    fclose(csv);
+  }
+  if (json)
+  {
+    fprintf(json, "\n  ]\n}\n");
+    fclose(json);
+  }
+  free(samples);
+  free(wakeSamples);
+  free(modeSelected);
+  free(zeros);
+  free(threadCounts);
+  free(sizes);
+  return 0;
+}
+
+/**
+ * Runs the regression suite selected by the `--regress` options in `argv` (see the usage message in `main()`).
+ * Every selected mode searches every selected scenario of every size, generated by `generateScenario()`: once untimed,
+ * then `repetitions` timed times. Each result is checked against `findMinSequential()`, and the median throughput
+ * against the baseline's for the same case, if it has one. Optionally writes the medians as a new baseline.
+ * @param argc The number of arguments in `argv`
+ * @param argv The arguments, starting with `--regress` itself
+ * @return The exit status: 0 if every result was right and no throughput regressed, 1 otherwise
+ */
+int runRegression(int argc, char const ** argv)
+{
+  static struct option const options[] = {
+    {"scenarios", required_argument, NULL, 'S'},
+    {"sizes", required_argument, NULL, 's'},
+    {"threads", required_argument, NULL, 't'},
+    {"seed", required_argument, NULL, 'e'},
+    {"modes", required_argument, NULL, 'm'},
+    {"repetitions", required_argument, NULL, 'r'},
+    {"threshold", required_argument, NULL, 'T'},
+    {"baseline", required_argument, NULL, 'b'},
+    {"save-baseline", required_argument, NULL, 'B'},
+    {NULL, 0, NULL, 0}
+  };
+  char const * scenarioList = NULL;
+  char const * sizeList = REGRESSION_SIZES;
+  size_t threadCount = REGRESSION_THREAD_COUNT;
+  uint64_t seed = RANDOM_SEED;
+  char const * modeList = NULL;
+  size_t repetitions = REGRESSION_REPETITIONS;
+  double threshold = REGRESSION_THRESHOLD;
+  char const * baselinePath = NULL;
+  char const * saveBaselinePath = NULL;
+  int option;
+  while ((option = getopt_long(argc, (char * const *) argv, "", options, NULL)) != -1)
+  {
+    switch (option)
+    {
+      case 'S': scenarioList = optarg; break;
+      case 's': sizeList = optarg; break;
+      case 't': threadCount = parseThreadCount(optarg); break;
+      case 'e': seed = parseSeed(optarg); break;
+      case 'm': modeList = optarg; break;
+      case 'r': repetitions = parseRepetitions(optarg); break;
+      case 'T': threshold = parseThreshold(optarg); break;
+      case 'b': baselinePath = optarg; break;
+      case 'B': saveBaselinePath = optarg; break;
+      default: printUsage(); return -1;
+    }
+  }
+  if (optind != argc)
+  {
+    printUsage();
+    return -1;
+  }
+  size_t * sizes;
+  size_t sizeCount = parseList(sizeList, &sizes, parseArraySize);
+  bool * scenarioSelected = parseSelection(scenarioList, scenarios, scenarioCount, sizeof(scenarios[0]), "scenario");
+  size_t scenario;
+  bool * modeSelected = parseSelection(modeList, searchModes, searchModeCount, sizeof(searchModes[0]), "search mode");
+  size_t mode;
+  BaselineEntry * baseline = NULL;
+  size_t baselineCount = baselinePath ? loadBaseline(baselinePath, &baseline) : 0;
+  FILE * saveBaseline = saveBaselinePath ? fopen(saveBaselinePath, "w") : NULL;
+  if (saveBaselinePath && !saveBaseline)
+  {
+    perror(saveBaselinePath);
+    exit(1);
+  }
+  if (saveBaseline)
+  {
+    fprintf(saveBaseline, "scenario,array_size,threads,mode,median_gbps\n");
+  }
+  printf("%-15s %12s %-10s %12s %9s %9s %8s %s\n", "scenario", "array_size", "mode", "median (us)", "GB/s",
+         "baseline", "change", "status");
+  uint64_t * samples = (uint64_t *) malloc(repetitions * sizeof(uint64_t));
+  size_t failureCount = 0;
+  size_t caseCount = 0;
+  ThreadPool * pool = createThreadPool(threadCount);
+  size_t sizeIndex;
+  for (scenario = 0; scenario < scenarioCount; ++scenario)
+  {
+    if (!scenarioSelected[scenario]) continue;
+    for (sizeIndex = 0; sizeIndex < sizeCount; ++sizeIndex)
+    {
+      size_t size = sizes[sizeIndex];
+      int * data = generateScenario(&scenarios[scenario], size, seed, threadCount);
+      int expected = findMinSequential(data, size);
+      for (mode = 0; mode < searchModeCount; ++mode)
+      {
+        if (!modeSelected[mode]) continue;
+        bool correct = true;
+        size_t repetition;
+        for (repetition = 0; repetition < 1 + repetitions; ++repetition)
+        {
+          SharedState sharedState = initSharedState(threadCount, FIND_MIN_CHUNK_SIZE);
+          uint64_t startTime = now();
+          int min = searchModes[mode].search(data, size, &sharedState, pool);
+          uint64_t elapsed = timeSince(startTime);
+          correct = correct && min == expected;
+          if (repetition >= 1)
+          {
+            samples[repetition - 1] = elapsed;
+          }
+        }
+        Statistics statistics = computeStatistics(samples, repetitions);
+        double gigabytesPerSecond = size * sizeof(int) / statistics.median;
+        BaselineEntry const * reference = NULL;
+        size_t i;
+        for (i = 0; i < baselineCount && !reference; ++i)
+        {
+          if (strcmp(baseline[i].scenario, scenarios[scenario].name) == 0 && baseline[i].size == size &&
+              baseline[i].threadCount == threadCount && strcmp(baseline[i].mode, searchModes[mode].name) == 0)
+          {
+            reference = &baseline[i];
+          }
+        }
+        double change = reference ? (gigabytesPerSecond / reference->gigabytesPerSecond - 1) * 100 : 0;
+        bool regressed = reference && change < -threshold;
+        char baselineText[32] = "-";
+        char changeText[32] = "-";
+        if (reference)
+        {
+          snprintf(baselineText, sizeof(baselineText), "%.2f", reference->gigabytesPerSecond);
+          snprintf(changeText, sizeof(changeText), "%+.1f%%", change);
+        }
+        printf("%-15s %12zu %-10s %12.1f %9.2f %9s %8s %s\n", scenarios[scenario].name, size, searchModes[mode].name,
+               statistics.median / 1000, gigabytesPerSecond, baselineText, changeText,
+               !correct ? "WRONG" : regressed ? "SLOWER" : "ok");
+        if (saveBaseline)
+        {
+          fprintf(saveBaseline, "%s,%zu,%zu,%s,%.3f\n", scenarios[scenario].name, size, threadCount,
+                  searchModes[mode].name, gigabytesPerSecond);
+        }
+        failureCount += !correct || regressed;
+        ++caseCount;
+      }
+      freeInput(data, size);
+    }
+  }
+  destroyThreadPool(pool);
+  if (saveBaseline && fclose(saveBaseline))
+  {
+    perror(saveBaselinePath);
+    exit(1);
+  }
+  printf("%zu of %zu cases failed (threshold %.1f%%, %zu threads, seed %llu)\n", failureCount, caseCount, threshold,
+         threadCount, (unsigned long long) seed);
+  free(samples);
+  free(baseline);
+  free(modeSelected);
+  free(scenarioSelected);
+  free(sizes);
+  return failureCount > 0 ? 1 : 0;
+}
+
+/**
+ * Writes `profile` to `path`, in a line-based text format read back by `loadTuningProfile()`.
+ * @return `false` (having reported why) if the file could not be written
+ */
+bool saveTuningProfile(TuningProfile const * profile, char const * path)
+{
+  FILE * file = fopen(path, "w");
+  if (!file)
+  {
+    perror(path);
+    return false;
+  }
+  fprintf(file, "mtfindmin-profile %d\n", TUNING_PROFILE_VERSION);
+  fprintf(file, "cpus %zu\nkernel %s\nsequential_bandwidth %.6g\nspawn_cost %.6g\nwake_cost %.6g\nchunk_size %zu\n",
+          profile->cpuCount, profile->kernel, profile->sequentialBandwidth, profile->spawnCost, profile->wakeCost,
+          profile->chunkSize);
+  fprintf(file, "points %zu\n", profile->pointCount);
+  size_t i;
+  for (i = 0; i < profile->pointCount; ++i)
+  {
+    fprintf(file, "%zu %.6g\n", profile->threadCounts[i], profile->bandwidths[i]);
+  }
+  if (fclose(file))
+  {
+    perror(path);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Submits `searchCount` searches at once, each of its own slice of a generated array (with no zero), and collects
+ * their results from a single epoll loop as their eventfds become readable. Every `ASYNC_CANCEL_INTERVAL`th search is
+ * cancelled right after it is submitted. The results of the others are checked against `findMinInt32()`, and the
+ * partial minima of the cancelled ones against its result as a lower bound.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used by each search
+ * @param searchCount The number of searches in flight at once
+ * @return The exit status: 0 if every result is right (or no less than the minimum if cancelled), 1 otherwise
+ */
+int searchAsync(size_t arraySize, size_t threadCount, size_t searchCount)
+{
+#ifdef __linux__
+  int * data = generateInput(arraySize, NO_ZERO, 1);
+  int epollFd = epoll_create1(EPOLL_CLOEXEC);
+  if (epollFd < 0)
+  {
+    perror("epoll_create1");
+    exit(1);
+  }
+  AsyncSearch ** searches = (AsyncSearch **) malloc(searchCount * sizeof(AsyncSearch *));
+  if (!searches)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  uint64_t startTime = now();
+  size_t i;
+  for (i = 0; i < searchCount; ++i)
+  {
+    size_t begin = arraySize * i / searchCount;
+    size_t end = arraySize * (i + 1) / searchCount;
+    searches[i] = submitSearch(data + begin, end - begin, threadCount, FIND_MIN_CHUNK_SIZE);
+    if (i % ASYNC_CANCEL_INTERVAL == ASYNC_CANCEL_INTERVAL - 1)
+    {
+      cancelSearch(searches[i]);
+    }
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = i;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, searches[i]->eventFd, &event))
+    {
+      perror("epoll_ctl");
+      exit(1);
+    }
+  }
+  uint64_t submitTime = timeSince(startTime);
+  size_t completed = 0;
+  size_t mismatches = 0;
+  size_t wakeups = 0;
+  while (completed < searchCount)
+  {
+    struct epoll_event events[64];
+    int eventCount = epoll_wait(epollFd, events, sizeof(events) / sizeof(events[0]), -1);
+    if (eventCount < 0)
+    {
+      if (errno == EINTR) continue;
+      perror("epoll_wait");
+      exit(1);
+    }
+    ++wakeups;
+    int e;
+    for (e = 0; e < eventCount; ++e)
+    {
+      size_t slice = events[e].data.u64;
+      AsyncSearch * search = searches[slice];
+      if (epoll_ctl(epollFd, EPOLL_CTL_DEL, search->eventFd, NULL))
+      {
+        perror("epoll_ctl");
+        exit(1);
+      }
+      int minimum;
+      if (!fetchSearchResult(search, &minimum))
+      {
+        fprintf(stderr, "Search %zu signalled before it was done\n", slice);
+        exit(1);
+      }
+      size_t begin = arraySize * slice / searchCount;
+      size_t end = arraySize * (slice + 1) / searchCount;
+      int reference = findMinInt32(data + begin, end - begin, NULL);
+      // A cancelled search may stop before it reaches the minimum, but never returns less than it
+      bool cancelled = slice % ASYNC_CANCEL_INTERVAL == ASYNC_CANCEL_INTERVAL - 1;
+      mismatches += cancelled ? minimum < reference : minimum != reference;
+      ++completed;
+    }
+  }
+  printf("%zu searches on %zu threads each submitted in %.3f ms and completed in %.3f ms, over %zu epoll wakeups\n",
+         searchCount, threadCount, (double) submitTime / 1000000, (double) timeSince(startTime) / 1000000, wakeups);
+  printf("%zu cancelled, %zu results disagree with findMinInt32()\n", searchCount / ASYNC_CANCEL_INTERVAL, mismatches);
+  close(epollFd);
+  free(searches);
+  freeInput(data, arraySize);
+  return mismatches == 0 ? 0 : 1;
+#else
+  (void) arraySize;
+  (void) threadCount;
+  (void) searchCount;
+  fprintf(stderr, "--async needs epoll, which is only available on Linux\n");
+  exit(1);
+#endif
+}
+
+/**
+ * Runs a batch of jobs of mixed sizes with `runBatch()`, and prints the aggregate throughput and the percentiles of the
+ * per-job latency, split into the time each job spent queued before a worker started on it and the time it took to
+ * search once started: as every job is submitted at once, the latency alone mostly reflects a job's place in the
+ * queue. The jobs are slices of one generated array (with no zero) as large as the largest job, at pseudo-random
+ * offsets; each job's minimum is checked against `findMinInt32()`.
+ * @param threadCount The number of workers
+ * @param path A workload file, as read by `readWorkload()`, or `NULL` for `BATCH_DEFAULT_JOB_COUNT` jobs of between
+ *             `BATCH_DEFAULT_MIN_BYTES` and `BATCH_DEFAULT_MAX_BYTES`
+ * @return The exit status: 0 if every job minimum is right, 1 otherwise
+ */
+int searchBatch(size_t threadCount, char const * path)
+{
+  size_t * sizes;
+  size_t jobCount;
+  size_t i;
+  if (path)
+  {
+    jobCount = readWorkload(path, &sizes);
+  }
+  else
+  {
+    jobCount = BATCH_DEFAULT_JOB_COUNT;
+    sizes = (size_t *) malloc(jobCount * sizeof(size_t));
+    if (!sizes)
+    {
+      perror("malloc");
+      exit(1);
+    }
+    double logRange = log((double) BATCH_DEFAULT_MAX_BYTES / BATCH_DEFAULT_MIN_BYTES);
+    for (i = 0; i < jobCount; ++i)
+    {
+      double unit = (double) (randomBits(RANDOM_SEED, i) >> 11) / (double) (1ULL << 53);
+      sizes[i] = (size_t) (BATCH_DEFAULT_MIN_BYTES * exp(unit * logRange)) / sizeof(int);
+    }
+  }
+  size_t maxSize = 0;
+  size_t totalSize = 0;
+  size_t splitCount = 0;
+  for (i = 0; i < jobCount; ++i)
+  {
+    maxSize = sizes[i] > maxSize ? sizes[i] : maxSize;
+    totalSize += sizes[i];
+    splitCount += sizes[i] > BATCH_SPLIT_SIZE;
+  }
+  int * data = generateInput(maxSize, NO_ZERO, threadCount);
+  BatchJob * jobs = (BatchJob *) malloc(jobCount * sizeof(BatchJob));
+  uint64_t * latencies = (uint64_t *) malloc(jobCount * sizeof(uint64_t));
+  uint64_t * queueDelays = (uint64_t *) malloc(jobCount * sizeof(uint64_t));
+  uint64_t * serviceTimes = (uint64_t *) malloc(jobCount * sizeof(uint64_t));
+  if (!jobs || !latencies || !queueDelays || !serviceTimes)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  for (i = 0; i < jobCount; ++i)
+  {
+    jobs[i].data = data + randomBits(RANDOM_SEED + 1, i) % (maxSize - sizes[i] + 1);
+    jobs[i].size = sizes[i];
+  }
+  uint64_t startTime = now();
+  runBatch(jobs, jobCount, threadCount);
+  double elapsed = (double) timeSince(startTime);
+  size_t mismatches = 0;
+  for (i = 0; i < jobCount; ++i)
+  {
+    latencies[i] = jobs[i].latency;
+    queueDelays[i] = jobs[i].startTime - jobs[i].submitTime;
+    serviceTimes[i] = jobs[i].latency - queueDelays[i];
+    mismatches += jobs[i].minimum != findMinInt32(jobs[i].data, jobs[i].size, NULL);
+  }
+  Statistics latency = computeStatistics(latencies, jobCount);
+  Statistics queueDelay = computeStatistics(queueDelays, jobCount);
+  Statistics serviceTime = computeStatistics(serviceTimes, jobCount);
+  printf("%zu jobs (%zu of them split) on %zu workers, %.3f GB in %.3f ms: %.0f jobs/s, %.2f GB/s\n", jobCount,
+         splitCount, threadCount, (double) totalSize * sizeof(int) / 1e9, elapsed / 1000000, jobCount / (elapsed / 1e9),
+         totalSize * sizeof(int) / elapsed);
+  printf("%-16s %10s %10s %10s %10s %10s\n", "(ms)", "min", "median", "p90", "p99", "max");
+  printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", "queueing delay", queueDelay.min / 1000000,
+         queueDelay.median / 1000000, queueDelay.p90 / 1000000, queueDelay.p99 / 1000000, queueDelay.max / 1000000);
+  printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", "service time", serviceTime.min / 1000000,
+         serviceTime.median / 1000000, serviceTime.p90 / 1000000, serviceTime.p99 / 1000000, serviceTime.max / 1000000);
+  printf("%-16s %10.3f %10.3f %10.3f %10.3f %10.3f\n", "latency", latency.min / 1000000, latency.median / 1000000,
+         latency.p90 / 1000000, latency.p99 / 1000000, latency.max / 1000000);
+  printf("%zu of %zu job minima disagree with findMinInt32()\n", mismatches, jobCount);
+  free(sizes);
+  free(jobs);
+  free(latencies);
+  free(queueDelays);
+  free(serviceTimes);
+  freeInput(data, maxSize);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Searches with parent busy waiting: the parent keeps polling the threads' results with `monitorThreads()`, and cancels
+ * the search as soon as it sees a zero.
+ */
+int searchBusyWaiting(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreaded);
+  monitorThreads(threadInfo, sharedState, true);
+  sharedState->observedTime = now();
+  joinAll(threadInfo, threadCount);
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches with chunks claimed dynamically by `findMinDynamic`, with the parent waiting for all threads.
+ */
+int searchDynamic(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinDynamic);
+  joinAll(threadInfo, threadCount);
+  sharedState->observedTime = now();
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches with the parent waiting for all threads with `pthread_join`.
+ */
+int searchJoined(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreaded);
+  joinAll(threadInfo, threadCount);
+  sharedState->observedTime = now();
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches with `findMinUntilInt32()` (or `findMinInt32()` for a full reduction), which manages its own threads.
+ * The stop latency is not reported, as the library does not expose when its threads stop.
+ */
+int searchLibrary(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  FindMinOptions options;
+  options.threadCount = sharedState->threadCount;
+  options.chunkSize = sharedState->chunkSize;
+  (void) pool;
+  return sharedState->stopOnZero ? findMinUntilInt32(data, size, 0, &options) : findMinInt32(data, size, &options);
+}
+
+/**
+ * Searches on the threads of `pool` rather than creating new ones.
+ */
+int searchOnPool(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  poolStartAll(pool, threadInfo, findMinThreaded);
+  poolJoinAll(pool);
+  sharedState->observedTime = now();
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  return min;
+}
+
+/**
+ * Builds a range minimum query index over a generated array (with no zero) and answers `queryCount` random ranges
+ * with it, printing the build time, the memory the index takes and the time per query. The first
+ * `RANGE_SCAN_SAMPLES` ranges are also answered by scanning them, to compare against and to check the results.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used to build the index and answer the queries
+ * @param queryCount The number of ranges to query
+ * @return The exit status: 0 if every sampled query agrees with a scan, 1 otherwise
+ */
+int searchRanges(size_t arraySize, size_t threadCount, size_t queryCount)
+{
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  size_t * begins = (size_t *) malloc(queryCount * sizeof(size_t));
+  size_t * ends = (size_t *) malloc(queryCount * sizeof(size_t));
+  int * minima = (int *) malloc(queryCount * sizeof(int));
+  if (!begins || !ends || !minima)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  size_t i;
+  for (i = 0; i < queryCount; ++i)
+  {
+    size_t a = randomBits(RANDOM_SEED, 2 * i) % (arraySize + 1);
+    size_t b = randomBits(RANDOM_SEED, 2 * i + 1) % (arraySize + 1);
+    begins[i] = a < b ? a : b;
+    ends[i] = a < b ? b : a;
+  }
+  FindMinOptions options;
+  options.threadCount = threadCount;
+  options.chunkSize = FIND_MIN_CHUNK_SIZE;
+  FindMinRangeIndexInt32 index;
+  uint64_t startTime = now();
+  if (findMinBuildRangeIndexInt32(&index, data, arraySize, 0, &options))
+  {
+    fprintf(stderr, "Out of memory building the range index\n");
+    exit(1);
+  }
+  uint64_t buildTime = timeSince(startTime);
+  size_t indexBytes = index.levelCount * index.blockCount * sizeof(int);
+  printf("Index built in %.3f ms: %zu levels of %zu blocks, %zu bytes (%.1f%% of the array)\n",
+         (double) buildTime / 1000000, index.levelCount, index.blockCount, indexBytes,
+         arraySize > 0 ? 100.0 * indexBytes / (arraySize * sizeof(int)) : 0.0);
+  startTime = now();
+  findMinRangesInt32(&index, begins, ends, queryCount, minima, &options);
+  uint64_t queryTime = timeSince(startTime);
+  size_t sampleCount = queryCount < RANGE_SCAN_SAMPLES ? queryCount : RANGE_SCAN_SAMPLES;
+  size_t mismatches = 0;
+  startTime = now();
+  for (i = 0; i < sampleCount; ++i)
+  {
+    mismatches += findMinInChunk(data + begins[i], ends[i] - begins[i], false) != minima[i];
+  }
+  uint64_t scanTime = timeSince(startTime);
+  printf("%zu queries answered in %.3f ms (%.1f ns per query), scanning took %.1f ns per query\n", queryCount,
+         (double) queryTime / 1000000, (double) queryTime / queryCount, (double) scanTime / sampleCount);
+  printf("%zu of %zu sampled queries disagree with a scan\n", mismatches, sampleCount);
+  findMinFreeRangeIndexInt32(&index);
+  free(begins);
+  free(ends);
+  free(minima);
+  freeInput(data, arraySize);
+  return mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Searches on the calling thread with `findMinSequential()`.
+ */
+int searchSequential(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  (void) sharedState;
+  (void) pool;
+  return findMinSequential(data, size);
+}
+
+/**
+ * Returns the minimum number found by all threads.
+ * @param threadCount The number of threads that were searching
+ * @param threadInfo An array of size `threadCount` with information about each thread
+ */
+int searchThreadMinima(size_t threadCount, ThreadInfo const * threadInfo)
+{
+  int min = INT_MAX;
+  size_t i;
+  for (i = 0; i < threadCount; i++)
+  {
+    int minimum = __atomic_load_n(&threadInfo[i].minimum, __ATOMIC_ACQUIRE);
+    if (minimum == 0)
+    {
+      return 0;
+    }
+    if (__atomic_load_n(&threadInfo[i].done, __ATOMIC_ACQUIRE) && minimum < min)
+    {
+      min = minimum;
+    }
+  }
+  return min;
+}
+
+/**
+ * Builds a min tree over a generated array (with no zero), then changes `updateCount` random elements one at a time
+ * and another `updateCount` in a single batch, and answers `updateCount` random range queries, printing the time per
+ * update and per query next to that of rescanning the whole array. The tree's minimum is checked against a rescan, and
+ * the first `RANGE_SCAN_SAMPLES` ranges against scans of them.
+ * @param arraySize The size of the array to search
+ * @param threadCount The number of threads used to build the tree, apply the batch and rescan the array
+ * @param updateCount The number of updates of each kind, and of range queries
+ * @return The exit status: 0 if the tree's minimum and every sampled range query agree with scans, 1 otherwise
+ */
+int searchUpdates(size_t arraySize, size_t threadCount, size_t updateCount)
+{
+  int * data = generateInput(arraySize, NO_ZERO, threadCount);
+  size_t * indices = (size_t *) malloc(updateCount * sizeof(size_t));
+  int * values = (int *) malloc(updateCount * sizeof(int));
+  size_t * ends = (size_t *) malloc(updateCount * sizeof(size_t));
+  if (!indices || !values || !ends)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  FindMinOptions options;
+  options.threadCount = threadCount;
+  options.chunkSize = FIND_MIN_CHUNK_SIZE;
+  FindMinTreeInt32 tree;
+  uint64_t startTime = now();
+  if (findMinBuildTreeInt32(&tree, data, arraySize, &options))
+  {
+    fprintf(stderr, "Out of memory building the min tree\n");
+    exit(1);
+  }
+  printf("Tree built in %.3f ms: %zu levels, %zu bytes\n", (double) timeSince(startTime) / 1000000, tree.levelCount,
+         tree.levelOffsets[tree.levelCount] * (sizeof(int) + 1));
+  startTime = now();
+  findMinInt32(data, arraySize, &options);
+  uint64_t rescanTime = timeSince(startTime);
+  printf("%-24s %14s %12s\n", "operation", "ns each", "vs rescan");
+  printf("%-24s %14.1f %12s\n", "full rescan", (double) rescanTime, "1x");
+  size_t pass;
+  for (pass = 0; pass < 2; ++pass)
+  {
+    size_t i;
+    for (i = 0; i < updateCount; ++i)
+    {
+      indices[i] = randomBits(RANDOM_SEED + 1 + pass, i) % arraySize;
+      // Values from 0 up, so updates can lower the minimum as well as raise it
+      values[i] = randomValue(RANDOM_SEED + 3 + pass, i) - 1;
+    }
+    startTime = now();
+    if (pass == 0)
+    {
+      for (i = 0; i < updateCount; ++i)
+      {
+        findMinTreeUpdateInt32(&tree, indices[i], values[i]);
+      }
+    }
+    else
+    {
+      findMinTreeUpdatesInt32(&tree, indices, values, updateCount, &options);
+    }
+    double updateTime = (double) timeSince(startTime) / updateCount;
+    printf("%-24s %14.1f %11.0fx\n", pass == 0 ? "point update" : "batched update", updateTime,
+           rescanTime / updateTime);
+  }
+  size_t i;
+  for (i = 0; i < updateCount; ++i)
+  {
+    size_t a = randomBits(RANDOM_SEED + 5, 2 * i) % (arraySize + 1);
+    size_t b = randomBits(RANDOM_SEED + 5, 2 * i + 1) % (arraySize + 1);
+    indices[i] = a < b ? a : b;
+    ends[i] = a < b ? b : a;
+  }
+  startTime = now();
+  for (i = 0; i < updateCount; ++i)
+  {
+    values[i] = findMinTreeRangeInt32(&tree, indices[i], ends[i]);
+  }
+  double queryTime = (double) timeSince(startTime) / updateCount;
+  printf("%-24s %14.1f %11.0fx\n", "range query", queryTime, rescanTime / queryTime);
+  int min = findMinTreeMinInt32(&tree);
+  int rescannedMin = findMinInt32(data, arraySize, &options);
+  size_t sampleCount = updateCount < RANGE_SCAN_SAMPLES ? updateCount : RANGE_SCAN_SAMPLES;
+  size_t mismatches = 0;
+  for (i = 0; i < sampleCount; ++i)
+  {
+    mismatches += findMinInChunk(data + indices[i], ends[i] - indices[i], false) != values[i];
+  }
+  printf("Min = %d (rescan: %d), %zu of %zu sampled range queries disagree with a scan\n", min, rescannedMin,
+         mismatches, sampleCount);
+  findMinFreeTreeInt32(&tree);
+  free(indices);
+  free(values);
+  free(ends);
+  freeInput(data, arraySize);
+  return min == rescannedMin && mismatches == 0 ? 0 : 1;
+}
+
+/**
+ * Searches with the parent waiting at a barrier with every thread. A zero cannot wake the parent early: it only stops
+ * the other threads, which then reach the barrier.
+ */
+int searchWithBarrier(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  WakeChannel channel;
+  if (pthread_barrier_init(&channel.barrier, NULL, (unsigned) threadCount + 1))
+  {
+    perror("pthread_barrier_init");
+    exit(1);
+  }
+  sharedState->channel = &channel;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreadedWithBarrier);
+  pthread_barrier_wait(&channel.barrier);
+  sharedState->observedTime = now();
+  joinAll(threadInfo, threadCount);
+  pthread_barrier_destroy(&channel.barrier);
+  sharedState->channel = NULL;
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches with the parent waiting on a condition variable, signalled by the last thread to finish or the first to
+ * find a zero.
+ */
+int searchWithCondition(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  WakeChannel channel;
+  if (pthread_mutex_init(&channel.mutex, NULL) || pthread_cond_init(&channel.changed, NULL))
+  {
+    perror("pthread_mutex_init");
+    exit(1);
+  }
+  channel.remaining = threadCount;
+  channel.signalled = false;
+  sharedState->channel = &channel;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreadedWithCondition);
+  pthread_mutex_lock(&channel.mutex);
+  while (!channel.signalled)
+  {
+    pthread_cond_wait(&channel.changed, &channel.mutex);
+  }
+  pthread_mutex_unlock(&channel.mutex);
+  sharedState->observedTime = now();
+  cancelAll(sharedState);
+  joinAll(threadInfo, threadCount);
+  pthread_cond_destroy(&channel.changed);
+  pthread_mutex_destroy(&channel.mutex);
+  sharedState->channel = NULL;
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches with the parent blocked reading an eventfd, which each thread adds to once it is done (see
+ * `findMinThreadedWithEventFd()`). Falls back to `searchWithCondition()` where there is no eventfd.
+ */
+int searchWithEventFd(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+#ifdef __linux__
+  size_t threadCount = sharedState->threadCount;
+  WakeChannel channel;
+  channel.eventFd = eventfd(0, EFD_CLOEXEC);
+  if (channel.eventFd == -1)
+  {
+    perror("eventfd");
+    exit(1);
+  }
+  sharedState->channel = &channel;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreadedWithEventFd);
+  uint64_t arrivals = 0;
+  while (arrivals < threadCount)
+  {
+    uint64_t count;
+    if (read(channel.eventFd, &count, sizeof(count)) != sizeof(count))
+    {
+      if (errno == EINTR) continue;
+      perror("read");
+      exit(1);
+    }
+    arrivals += count;
+  }
+  sharedState->observedTime = now();
+  cancelAll(sharedState);
+  joinAll(threadInfo, threadCount);
+  close(channel.eventFd);
+  sharedState->channel = NULL;
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+#else
+  return searchWithCondition(data, size, sharedState, pool);
+#endif
+}
+
+/**
+ * Searches with the parent waiting on `sharedState->searchDone`, which is signalled by the thread that finds a zero or
+ * by the last thread to finish.
+ */
+int searchWithSemaphore(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
+  startAll(threadInfo, threadCount, findMinThreadedWithSemaphore);
+  waitForCompletion(&sharedState->searchDone);
+  sharedState->observedTime = now();
+  cancelAll(sharedState);
+  joinAll(threadInfo, threadCount);
+  int min = searchThreadMinima(threadCount, threadInfo);
+  free(threadInfo);
+  (void) pool;
+  return min;
+}
+
+/**
+ * Searches like `searchWithSemaphore()`, but with the parent polling the completion (backing off as `backOff()` does
+ * before it yields) before it sleeps on it, so that a search that ends soon wakes it without a system call.
+ */
+int searchWithSpinFutex(int const * data, size_t size, SharedState * sharedState, ThreadPool * pool)
+{
+  size_t threadCount = sharedState->threadCount;
+  ThreadInfo * threadInfo = computeThreadInfo(data, size, threadCount, sharedState);
   startAll(threadInfo, threadCount, findMinThreadedWithSemaphore);
-  if (sem_wait(&sharedState.searchDone))
-  {
-    perror("sem_wait");
-    exit(1);
-  }
-  cancelAll(threadInfo, threadCount);
+  waitForCompletionSpinning(&sharedState->searchDone);
+  sharedState->observedTime = now();
+  cancelAll(sharedState);
   joinAll(threadInfo, threadCount);
-  min = searchThreadMinima(threadCount, threadInfo);
-  printf("Threaded search with parent waiting on a semaphore completed in %ld ms. Min = %d\n", timeSince(startTime),
-         min);
-  freeSharedState(&sharedState);
+  int min = searchThreadMinima(threadCount, threadInfo);
   free(threadInfo);
-  free(data);
-  return 0;
+  (void) pool;
+  return min;
 }
 
 /**
- * Returns `true` if all threads are done.
+ * Chooses the CPUs threads are pinned to, according to the placement policy named `policy` (`compact`, `scatter`,
+ * `physical` or `none`), from the topology found by `discoverTopology()`, and reports the placement on stderr.
+ * Exits with an error if the policy is unknown. On a single-node machine the policies reduce to pinning threads to
+ * cores: `scatter` and `physical` use every core before any SMT sibling, while `compact` fills each core in turn.
  */
-bool allThreadsDone(size_t threadCount, ThreadInfo const * threadInfo)
+void setPlacement(char const * policy)
 {
+  int placement;
+  if (strcmp(policy, "none") == 0)
+  {
+    threadCpuCount = 0;
+    return;
+  }
+  else if (strcmp(policy, "compact") == 0)
+  {
+    placement = PLACEMENT_COMPACT;
+  }
+  else if (strcmp(policy, "scatter") == 0)
+  {
+    placement = PLACEMENT_SCATTER;
+  }
+  else if (strcmp(policy, "physical") == 0)
+  {
+    placement = PLACEMENT_PHYSICAL;
+  }
+  else
+  {
+    fprintf(stderr, "Unknown affinity policy %s (expected compact, scatter, physical or none)\n", policy);
+    exit(-1);
+  }
+#ifdef __linux__
+  CpuInfo * cpus;
+  size_t count = discoverTopology(&cpus);
+  qsort(cpus, count, sizeof(CpuInfo), placement == PLACEMENT_SCATTER ? compareScatter : compareCompact);
+  free(threadCpus);
+  threadCpus = (int *) malloc((count > 0 ? count : 1) * sizeof(int));
+  if (!threadCpus)
+  {
+    perror("malloc");
+    exit(1);
+  }
+  threadCpuCount = 0;
+  size_t nodeCount = 0;
+  size_t coreCount = 0;
   size_t i;
-  for (i = 0; i < threadCount; ++i)
+  for (i = 0; i < count; ++i)
   {
-    if (!threadInfo[i].done) return false;
+    if (placement != PLACEMENT_PHYSICAL || cpus[i].thread == 0)
+    {
+      threadCpus[threadCpuCount++] = cpus[i].cpu;
+    }
+    coreCount += cpus[i].thread == 0;
+    nodeCount += cpus[i].thread == 0 && cpus[i].coreRank == 0;
   }
-  return true;
+  fprintf(stderr, "Pinning threads (%s) over %zu NUMA node(s), %zu core(s) and %zu CPU(s), to CPUs", policy,
+          nodeCount, coreCount, count);
+  for (i = 0; i < threadCpuCount && i < AFFINITY_REPORTED_CPUS; ++i)
+  {
+    fprintf(stderr, "%s%d", i == 0 ? " " : ",", threadCpus[i]);
+  }
+  fprintf(stderr, "%s\n", threadCpuCount > AFFINITY_REPORTED_CPUS ? ",..." : "");
+  free(cpus);
+#else
+  (void) placement;
+  fprintf(stderr, "--affinity is only supported on Linux; threads are not pinned\n");
+#endif
 }
 
 /**
- * Calls `pthread_cancel` on every thread in `threads`.
- * @param threads The threads to be cancelled
- * @param threadCount The number of threads in `threads`
+ * Signals `completion`, waking the thread waiting for it. Signalling an already signalled completion does nothing.
  */
-void cancelAll(ThreadInfo * threadInfo, size_t threadCount)
+void signalCompletion(Completion * completion)
 {
-  size_t i;
-  for (i = 0; i < threadCount; ++i)
+  if (__atomic_exchange_n(&completion->state, COMPLETION_SIGNALLED, __ATOMIC_ACQ_REL) == COMPLETION_SLEEPING)
   {
-    if (!threadInfo[i].done && pthread_cancel(threadInfo[i].threadHandle))
+#ifdef __linux__
+    if (syscall(SYS_futex, &completion->state, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0) == -1)
     {
-      fprintf(stderr, "Tried to cancel a thread that does not exist.\n");
+      perror("futex");
       exit(1);
     }
+#endif
   }
 }
 
 /**
- * Generates a heap allocated array of `ThreadInfo` - one for each thread.
- * @param data The data the threads will be operating on
- * @param arraySize The size of `data`
- * @param threadCount The number of threads (and the number of `ThreadInfo` structs to create)
- * @return An array of size `threadCount` (heap allocated - freeing is the responsibility of the caller)
+ * Forks a process that spins on the CPU until it is killed, to simulate a loaded host.
+ * The hog dies with this process (killed by the kernel on Linux, and otherwise when it next checks), so that it cannot
+ * outlive an early `exit()` or a signal.
+ * @return The process ID of the hog
  */
-ThreadInfo * computeThreadInfo(int const * data, size_t arraySize, size_t threadCount, SharedState * sharedState)
+pid_t startHog()
 {
-  ThreadInfo * threadInfo = (ThreadInfo *) malloc(threadCount * sizeof(ThreadInfo));
-  size_t i;
-  for (i = 0; i < threadCount; ++i)
+  pid_t parent = getpid();
+  pid_t pid = fork();
+  if (pid < 0)
   {
-    threadInfo[i].done = false;
-    threadInfo[i].data = data;
-    threadInfo[i].minimum = MAX_RANDOM_NUMBER + 1;
-    threadInfo[i].begin_region = i * arraySize / threadCount;
-    threadInfo[i].end_region = (i + 1) * arraySize / threadCount;
-    threadInfo[i].sharedState = sharedState;
+    perror("fork");
+    exit(1);
   }
-  return threadInfo;
+  if (pid == 0)
+  {
+#ifdef __linux__
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+    // The parent may have died before the death signal was asked for, and where there is no death signal it is polled
+    volatile unsigned long spin = 0;
+    while (true)
+    {
+      if (spin++ % HOG_PARENT_CHECK_INTERVAL == 0 && getppid() != parent)
+      {
+        _exit(0);
+      }
+    }
+  }
+  return pid;
 }
 
 /**
- * Find the minimum value in the given region of `data`
- * The region to be searched is specified by `[begin, end)`.
- * @param data The data to be searched
- * @param begin The index of the beginning of the region to search (inclusive)
- * @param end The index of the end of the region to search (exclusive)
- * @return The minimum value in the region `[begin, end)` of `data`
+ * Starts all threads.
+ * @param threads An array of thread handles
+ * @param threadInfo An array of thread information
+ * @param threadCount The number of threads
+ * @param f The function to run
  */
-int findMinInRegion(int const * data, size_t begin, size_t end)
+void startAll(ThreadInfo * threadInfo, size_t threadCount, void * (* f)(void *))
 {
-  int min = MAX_RANDOM_NUMBER + 1;
   size_t i;
-  for (i = begin; i < end; ++i)
+  for (i = 0; i < threadCount; ++i)
   {
-    pthread_testcancel();
-    if (data[i] == 0) return 0;
-    if (data[i] < min)
+    pthread_attr_t attr;
+    initThreadAttr(&attr, i);
+    if (pthread_create(&threadInfo[i].threadHandle, &attr, f, &threadInfo[i]))
     {
-      min = data[i];
+      perror("pthread_create");
+      exit(1);
     }
+    pthread_attr_destroy(&attr);
   }
-  return min;
 }
 
 /**
- * Find the minimum value in `data`. Single threaded.
- * @param data The data to be searched
- * @param size The size of `data`
- * @return The minimum value in `data`
+ * Serves the same function as `atoi()`, but performs a number of checks.
+ * Checks that `str` is a numeric value, and also that it is in the range of `int`
  */
-int findMinSequential(int const * const data, size_t size)
+int stoi(char const * str)
 {
-  return findMinInRegion(data, 0, size);
+  char * end;
+  errno = 0;
+  // Use strtol because atoi does not do any error checking
+  // 10 is for base-10
+  long val = strtol(str, &end, 10);
+  // If there was an error, (if the string is not numeric)
+  if (end == str || *end != '\0' || errno == ERANGE)
+  {
+    printf("%s is not a number.\n", str);
+    exit(1);
+  }
+  // Check if val is outside of int range
+  if (val < INT_MIN || val > INT_MAX)
+  {
+    printf("%s has too many digits.\n", str);
+    exit(1);
+  }
+  // Casting long to int is now safe
+  return (int) val;
 }
 
 /**
- * Find the minimum value in `data`. Multi threaded. No early exit.
- * @param region The region of `data` to search
- * @return The minimum value in the specified region of `data`
+ * Serves the same function as `atoll()`, but performs the same checks as `stoi()`.
  */
-void * findMinThreaded(void * threadInfo)
+long long stoll(char const * str)
 {
-  ThreadInfo * ti = (ThreadInfo *) threadInfo;
-  ti->minimum = findMinInRegion(ti->data, ti->begin_region, ti->end_region);
-  ti->done = true;
-  return NULL;
+  char * end;
+  errno = 0;
+  long long val = strtoll(str, &end, 10);
+  if (end == str || *end != '\0' || errno == ERANGE)
+  {
+    printf("%s is not a number.\n", str);
+    exit(1);
+  }
+  return val;
 }
 
-void * findMinThreadedWithSemaphore(void * threadInfo)
+/**
+ * The body of a stream search's reader thread: fills free buffers from the stream and hands them to the workers, until
+ * the stream ends or a zero is found. Then tells every worker to exit.
+ * A read that returns less than a full buffer hands over what it got rather than waiting for more, so a slow producer's
+ * data is searched as it arrives. Bytes of an `int` split across reads are carried over to the next buffer.
+ */
+void * streamReaderMain(void * streamState)
 {
-  ThreadInfo * ti = (ThreadInfo *) threadInfo;
-  ti->minimum = findMinInRegion(ti->data, ti->begin_region, ti->end_region);
-  if (ti->minimum == 0)
+  StreamState * stream = (StreamState *) streamState;
+  size_t const blockBytes = stream->blockSize * sizeof(int);
+  char carry[sizeof(int)];
+  size_t carryBytes = 0;
+  bool endOfStream = false;
+  struct pollfd fds[2];
+  fds[0].fd = stream->fd;
+  fds[0].events = POLLIN;
+  fds[1].fd = stream->wakePipe[0];
+  fds[1].events = POLLIN;
+  while (!endOfStream && !__atomic_load_n(&stream->sharedState->stop, __ATOMIC_RELAXED))
   {
-    if (sem_post(&ti->sharedState->searchDone))
+    size_t slot = popSlot(&stream->freeSlots);
+    char * buffer = (char *) (stream->buffers + slot * stream->blockSize);
+    memcpy(buffer, carry, carryBytes);
+    size_t filled = carryBytes;
+    while (filled < blockBytes)
     {
-      perror("sem_post");
-      exit(1);
+      if (poll(fds, 2, -1) < 0)
+      {
+        if (errno == EINTR) continue;
+        perror("poll");
+        exit(1);
+      }
+      if (fds[1].revents) break;
+      ssize_t bytesRead = read(stream->fd, buffer + filled, blockBytes - filled);
+      if (bytesRead < 0)
+      {
+        if (errno == EINTR) continue;
+        perror("read");
+        exit(1);
+      }
+      if (bytesRead == 0)
+      {
+        endOfStream = true;
+        break;
+      }
+      filled += bytesRead;
+      if (filled >= sizeof(int) && filled < blockBytes) break;
     }
+    size_t length = filled / sizeof(int);
+    carryBytes = filled % sizeof(int);
+    memcpy(carry, buffer + length * sizeof(int), carryBytes);
+    __atomic_fetch_add(&stream->elementCount, length, __ATOMIC_RELAXED);
+    stream->blockLengths[slot] = length;
+    pushSlot(length > 0 ? &stream->filledSlots : &stream->freeSlots, slot);
   }
-  else
+  if (endOfStream && carryBytes)
   {
-    if (sem_wait(&ti->sharedState->doneThreadCountMutex))
-    {
-      perror("sem_wait");
-      exit(1);
-    }
-    if (++ti->sharedState->doneThreadCount == 0)
+    fprintf(stderr, "Ignoring the last %zu bytes of the stream\n", carryBytes);
+  }
+  size_t i;
+  for (i = 0; i < stream->sharedState->threadCount; ++i)
+  {
+    pushSlot(&stream->filledSlots, END_OF_STREAM);
+  }
+  return NULL;
+}
+
+/**
+ * The body of a stream search's worker threads: searches filled buffers and returns them to the reader, keeping the
+ * stream's running minimum up to date, until told the stream has ended.
+ * Buffers handed over after a zero was found are returned without being searched.
+ */
+void * streamWorkerMain(void * streamState)
+{
+  StreamState * stream = (StreamState *) streamState;
+  while (true)
+  {
+    size_t slot = popSlot(&stream->filledSlots);
+    if (slot == END_OF_STREAM) break;
+    if (!__atomic_load_n(&stream->sharedState->stop, __ATOMIC_RELAXED))
     {
-      if (sem_post(&ti->sharedState->searchDone))
+      int min = findMinInRegion(stream->buffers + slot * stream->blockSize, 0, stream->blockLengths[slot],
+                                stream->sharedState);
+      int runningMin = __atomic_load_n(&stream->minimum, __ATOMIC_RELAXED);
+      while (min < runningMin &&
+             !__atomic_compare_exchange_n(&stream->minimum, &runningMin, min, false, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED))
       {
-        perror("sem_post");
-        exit(1);
+      }
+      if (min == 0)
+      {
+        reportZero(stream->sharedState);
+        if (write(stream->wakePipe[1], "", 1) < 0)
+        {
+          perror("write");
+        }
       }
     }
-    if (sem_post(&ti->sharedState->doneThreadCountMutex))
-    {
-      perror("sem_post");
-      exit(1);
-    }
+    pushSlot(&stream->freeSlots, slot);
   }
+  reportStopped(stream->sharedState);
   return NULL;
 }
 
-void freeSharedState(SharedState * sharedState)
+/**
+ * Starts searching `data` for its minimum on `threadCount` threads (stopping early at a zero), and returns at once.
+ * Note: allocates the search dynamically - it is freed by `fetchSearchResult()`, once done.
+ * @return The search, whose `eventFd` becomes readable once it is done
+ */
+AsyncSearch * submitSearch(int const * data, size_t size, size_t threadCount, size_t chunkSize)
 {
-  if (sem_destroy(&sharedState->searchDone))
+  AsyncSearch * search = (AsyncSearch *) malloc(sizeof(AsyncSearch));
+  if (!search)
   {
-    perror("sem_destroy");
+    perror("malloc");
+    exit(1);
   }
-  if (sem_destroy(&sharedState->doneThreadCountMutex))
+  search->sharedState = initSharedState(threadCount, chunkSize);
+  search->threadInfo = computeThreadInfo(data, size, threadCount, &search->sharedState);
+  search->running = threadCount;
+#ifdef __linux__
+  search->eventFd = search->signalFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (search->eventFd < 0)
   {
-    perror("sem_destroy");
+    perror("eventfd");
+    exit(1);
   }
+#else
+  int fds[2];
+  if (pipe(fds))
+  {
+    perror("pipe");
+    exit(1);
+  }
+  search->eventFd = fds[0];
+  search->signalFd = fds[1];
+#endif
+  startAll(search->threadInfo, threadCount, asyncSearchThread);
+  return search;
 }
 
 /**
- * Creates an array of integers between 1 and `MAX_RANDOM_NUMBER`.
- * Places a single `0` at `indexOfZero`.
- * Note: allocates the array dynamically - freeing is the responsibility of the caller.
- * @param size The size of the array created
- * @param indexOfZero The index at which to place a `0`. If -1, no zero is placed.
- * @returns The created array
+ * A thread of `benchmarkCompletion()` that arrives at `benchmark->completion` as soon as every thread is ready.
  */
-int * generateInput(size_t size, int indexOfZero)
+void * timeCompletionArrival(void * benchmark)
 {
-  if (indexOfZero >= (int) size) return NULL;
-  srand(RANDOM_SEED);
-  int * array = (int *) malloc(size * sizeof(int));
-  size_t i;
-  for (i = 0; i < size; ++i)
-  {
-    array[i] = rand() % MAX_RANDOM_NUMBER + 1;
-  }
-  if (indexOfZero >= 0)
-  {
-    array[indexOfZero] = 0;
-  }
-  return array;
+  CompletionBenchmark * b = (CompletionBenchmark *) benchmark;
+  pthread_barrier_wait(&b->start);
+  recordArrival(b);
+  arriveAtCompletion(&b->completion);
+  return NULL;
 }
 
-SharedState initSharedState(size_t threadCount)
+/**
+ * A thread of `benchmarkCompletion()` that counts itself done under `benchmark->doneCountMutex` as soon as every thread
+ * is ready, and posts `benchmark->done` if it is the last one.
+ */
+void * timeSemaphoreArrival(void * benchmark)
 {
-  SharedState sharedState;
-  // shared = false, value = 1
-  if (sem_init(&sharedState.searchDone, false, 0))
+  CompletionBenchmark * b = (CompletionBenchmark *) benchmark;
+  pthread_barrier_wait(&b->start);
+  recordArrival(b);
+  if (sem_wait(&b->doneCountMutex))
   {
-    perror("sem_init");
+    perror("sem_wait");
     exit(1);
   }
-  if (sem_init(&sharedState.doneThreadCountMutex, false, 1))
+  if (++b->doneCount == b->threadCount && sem_post(&b->done))
   {
-    perror("sem_init");
+    perror("sem_post");
     exit(1);
   }
-  sharedState.doneThreadCount = 0;
-  sharedState.threadCount = threadCount;
-  return sharedState;
+  if (sem_post(&b->doneCountMutex))
+  {
+    perror("sem_post");
+    exit(1);
+  }
+  return NULL;
 }
 
 /**
- * Calls `pthread_join` on every thread in `threads`.
- * @param threads The threads to be joined
- * @param threadCount The number of threads in `threads`
+ * Returns the number of nanoseconds that have passed since `time`.
  */
-void joinAll(ThreadInfo const * threadInfo, size_t threadCount)
+uint64_t timeSince(uint64_t time)
+{
+  return now() - time;
+}
+
+/**
+ * Writes a zero to each page of the region of the array described by `threadInfo`, so that this thread is the first
+ * to touch it, without spending time on values that are about to be overwritten.
+ */
+void * touchRegion(void * threadInfo)
 {
+  ThreadInfo * ti = (ThreadInfo *) threadInfo;
+  int * data = (int *) ti->data;
   size_t i;
-  for (i = 0; i < threadCount; ++i)
+  for (i = ti->begin_region; i < ti->end_region; i += SMALL_PAGE_SIZE / sizeof(int))
   {
-    if (pthread_join(threadInfo[i].threadHandle, NULL))
-    {
-      perror("pthread_join");
-      exit(1);
-    }
+    data[i] = 0;
   }
+  return NULL;
 }
 
 /**
- * Returns the current time in milliseconds.
+ * Finds where the tuning profile is cached: `$MTFINDMIN_PROFILE`, or `mtfindmin.profile` in `$XDG_CACHE_HOME` or
+ * else in `~/.cache` (which is created if need be).
+ * @return `false` if none of these variables is set
  */
-time_t now()
+bool tuningProfilePath(char * path, size_t size)
 {
-  struct timeb timeBuf;
-  ftime(&timeBuf);
-  return timeBuf.time * 1000 + timeBuf.millitm;
+  char const * profile = getenv("MTFINDMIN_PROFILE");
+  char const * cacheHome = getenv("XDG_CACHE_HOME");
+  char const * home = getenv("HOME");
+  if (profile && *profile)
+  {
+    snprintf(path, size, "%s", profile);
+  }
+  else if (cacheHome && *cacheHome)
+  {
+    snprintf(path, size, "%s/mtfindmin.profile", cacheHome);
+  }
+  else if (home && *home)
+  {
+    snprintf(path, size, "%s/.cache", home);
+    mkdir(path, 0755);
+    snprintf(path, size, "%s/.cache/mtfindmin.profile", home);
+  }
+  else
+  {
+    return false;
+  }
+  return true;
 }
 
 /**
- * Returns the minimum number found by all threads.
- * @param threadCount The number of threads that were searching
- * @param threadInfo An array of size `threadCount` with information about each thread
+ * Blocks until `completion` is signalled. Only one thread may wait for a completion.
+ * On Linux the waiter sleeps on a futex; elsewhere it polls with `backOff()`.
  */
-int searchThreadMinima(size_t threadCount, ThreadInfo const * threadInfo)
+void waitForCompletion(Completion * completion)
 {
-  int min = MAX_RANDOM_NUMBER + 1;
-  size_t i;
-  for (i = 0; i < threadCount; i++)
+#ifdef __linux__
+  int pending = COMPLETION_PENDING;
+  __atomic_compare_exchange_n(&completion->state, &pending, COMPLETION_SLEEPING, false, __ATOMIC_ACQUIRE,
+                              __ATOMIC_ACQUIRE);
+  while (__atomic_load_n(&completion->state, __ATOMIC_ACQUIRE) != COMPLETION_SIGNALLED)
   {
-    if (threadInfo[i].minimum == 0)
-    {
-      return 0;
-    }
-    if (threadInfo[i].done && threadInfo[i].minimum < min)
+    if (syscall(SYS_futex, &completion->state, FUTEX_WAIT_PRIVATE, COMPLETION_SLEEPING, NULL, NULL, 0) == -1 &&
+        errno != EAGAIN && errno != EINTR)
     {
-      min = threadInfo[i].minimum;
+      perror("futex");
+      exit(1);
     }
   }
-  return min;
+#else
+  unsigned spins = 1;
+  while (__atomic_load_n(&completion->state, __ATOMIC_ACQUIRE) != COMPLETION_SIGNALLED)
+  {
+    backOff(&spins);
+  }
+#endif
 }
 
 /**
- * Starts all threads.
- * @param threads An array of thread handles
- * @param threadInfo An array of thread information
- * @param threadCount The number of threads
- * @param f The function to run
+ * Waits for `completion` like `waitForCompletion()`, but spins on it for up to `BACKOFF_SPIN_LIMIT` `pause`s (doubling
+ * between polls) before going to sleep.
  */
-void startAll(ThreadInfo * threadInfo, size_t threadCount, void * (* f)(void *))
+void waitForCompletionSpinning(Completion * completion)
 {
-  size_t i;
-  for (i = 0; i < threadCount; ++i)
+  unsigned spins = 1;
+  while (spins <= BACKOFF_SPIN_LIMIT)
   {
-    if (pthread_create(&threadInfo[i].threadHandle, NULL, f, &threadInfo[i]))
-    {
-      perror("pthread_create");
-      exit(1);
-    }
+    if (__atomic_load_n(&completion->state, __ATOMIC_ACQUIRE) == COMPLETION_SIGNALLED) return;
+    backOff(&spins);
   }
+  waitForCompletion(completion);
 }
 
 /**
- * Serves the same function as `atoi()`, but performs a number of checks.
- * Checks that `str` is a numeric value, and also that it is in the range of `int`
+ * Returns how long the parent of a search took to see that it was over: from the first zero being found if one was,
+ * or else from the last thread stopping - or 0 if the search mode does not record when its parent saw it.
  */
-int stoi(char const * str)
+uint64_t wakeLatency(SharedState const * sharedState)
 {
-  char * end;
-  errno = 0;
-  // Use strtol because atoi does not do any error checking
-  // 10 is for base-10
-  long val = strtol(str, &end, 10);
-  // If there was an error, (if the string is not numeric)
-  if (end == str || *end != '\0' || errno == ERANGE)
+  if (sharedState->observedTime == 0) return 0;
+  uint64_t end = sharedState->zeroFoundTime != 0 ? sharedState->zeroFoundTime : sharedState->lastStopTime;
+  return sharedState->observedTime > end ? sharedState->observedTime - end : 0;
+}
+
+/**
+ * Writes `size` integers from `data` to the file at `path`, in the format read by `mapInputFile()`.
+ */
+void writeInputFile(char const * path, int const * data, size_t size)
+{
+  FILE * file = fopen(path, "wb");
+  if (!file)
   {
-    printf("%s is not a number.\n", str);
+    perror(path);
     exit(1);
   }
-  // Check if val is outside of int range
-  if (val < INT_MIN || val > INT_MAX)
+  if (fwrite(data, sizeof(int), size, file) != size || fclose(file))
   {
-    printf("%s has too many digits.\n", str);
+    perror("fwrite");
     exit(1);
   }
-  // Casting long to int is now safe
-  return (int) val;
-}
-
-/**
- * Returns the number of milliseconds that have passed since `time`.
- */
-time_t timeSince(time_t time)
-{
-  return now() - time;
 }